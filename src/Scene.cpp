@@ -1,5 +1,7 @@
 #include "Scene.h"
 
+#include <algorithm>
+#include <cmath>
 #include <utility>
 #include "Entity.h"
 #include "common.hpp"
@@ -14,18 +16,39 @@ namespace ECS_ENTT {
 		m_BackgroundFilename(""),
 		m_Size(vec2(size.x * SPRITE_SCALE, size.y * SPRITE_SCALE)),
 		m_Camera(new Camera()),
-		m_Map(LevelMap(size.y,LevelRow(size.x))),
-		m_Weather(WeatherTypes::Sunny)
-		{};
+		m_Map(size_t(size.y), LevelRow(size_t(size.x)), &m_Arena),
+		m_Weather(WeatherTypes::Sunny),
+		m_TileGrid(size_t(size.x * size.y), entt::entity{ entt::null }, &m_Arena),
+		m_DirtyTileChunks(size_t(GetNumChunkRows() * GetNumChunkCols()), false, &m_Arena),
+		m_Roster(&m_Arena)
+	{
+		m_Registry.on_construct<Tile>().connect<&Scene::OnTileCreated>(*this);
+		m_Registry.on_destroy<Tile>().connect<&Scene::OnTileDestroyed>(*this);
+		m_Registry.on_construct<Turn>().connect<&Scene::OnRosterChanged>(*this);
+		m_Registry.on_destroy<Turn>().connect<&Scene::OnRosterChanged>(*this);
+	};
 
 	Scene::Scene(std::string name, glm::vec2 size, Camera* camera) :
 		m_Name(std::move(name)),
 		m_BackgroundFilename(""),
 		m_Size(vec2(size.x * SPRITE_SCALE, size.y * SPRITE_SCALE)),
 		m_Camera(camera),
-		m_Map(LevelMap(size.y,LevelRow(size.x))),
-		m_Weather(WeatherTypes::Sunny)
-		{};
+		m_Map(size_t(size.y), LevelRow(size_t(size.x)), &m_Arena),
+		m_Weather(WeatherTypes::Sunny),
+		m_TileGrid(size_t(size.x * size.y), entt::entity{ entt::null }, &m_Arena),
+		m_DirtyTileChunks(size_t(GetNumChunkRows() * GetNumChunkCols()), false, &m_Arena),
+		m_Roster(&m_Arena)
+	{
+		m_Registry.on_construct<Tile>().connect<&Scene::OnTileCreated>(*this);
+		m_Registry.on_destroy<Tile>().connect<&Scene::OnTileDestroyed>(*this);
+		m_Registry.on_construct<Turn>().connect<&Scene::OnRosterChanged>(*this);
+		m_Registry.on_destroy<Turn>().connect<&Scene::OnRosterChanged>(*this);
+	};
+
+	Scene::~Scene()
+	{
+		delete m_Camera;
+	}
 
 	// Create an entity and associate it to this Scene
 	Entity Scene::CreateEntity(const std::string& name)
@@ -66,11 +89,34 @@ namespace ECS_ENTT {
 		m_NumPlayers = n;
 	}
 
+	const std::pmr::vector<entt::entity>& Scene::GetRoster()
+	{
+		if (m_RosterDirty)
+		{
+			auto bros = m_Registry.view<Turn>();
+			m_Roster.assign(bros.begin(), bros.end());
+			std::sort(m_Roster.begin(), m_Roster.end(), [&bros](entt::entity a, entt::entity b) {
+				return bros.get<Turn>(a).order < bros.get<Turn>(b).order;
+			});
+			m_RosterDirty = false;
+		}
+		return m_Roster;
+	}
+
+	entt::entity Scene::GetRosterEntity(unsigned int order)
+	{
+		const auto& roster = GetRoster();
+		if (order >= roster.size())
+			return entt::null;
+		assert(m_Registry.get<Turn>(roster[order]).order == order);
+		return roster[order];
+	}
+
 	void Scene::PointCamera(vec3 position) {
 		m_Camera->SetPosition(vec3(position.x, position.y, m_Camera->GetPosition().z));
 	}
 
-	std::queue<std::string> Scene::GetDialogueBoxNames() {
+	const std::queue<std::string>& Scene::GetDialogueBoxNames() const {
 		return dialogue_box_names;
 	}
 
@@ -78,4 +124,64 @@ namespace ECS_ENTT {
 		dialogue_box_names.pop();
 	}
 
+	entt::entity Scene::GetTile(int row, int col) const
+	{
+		if (row < 0 || col < 0 || row >= GetNumRows() || col >= GetNumCols())
+			return entt::null;
+		return m_TileGrid[row * GetNumCols() + col];
+	}
+
+	int Scene::GetNumChunkRows() const
+	{
+		return (GetNumRows() + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	}
+
+	int Scene::GetNumChunkCols() const
+	{
+		return (GetNumCols() + TILE_CHUNK_SIZE - 1) / TILE_CHUNK_SIZE;
+	}
+
+	void Scene::MarkTileChunkDirty(int cell)
+	{
+		int row = cell / GetNumCols();
+		int col = cell % GetNumCols();
+		m_DirtyTileChunks[(row / TILE_CHUNK_SIZE) * GetNumChunkCols() + col / TILE_CHUNK_SIZE] = true;
+	}
+
+	int Scene::GetCellIndex(glm::vec3 position) const
+	{
+		// Entities created from the level map are centered on their cell
+		int row = (int)std::round(position.y / SPRITE_SCALE);
+		int col = (int)std::round(position.x / SPRITE_SCALE);
+		if (row < 0 || col < 0 || row >= GetNumRows() || col >= GetNumCols())
+			return -1;
+		return row * GetNumCols() + col;
+	}
+
+	void Scene::OnTileCreated(entt::registry& registry, entt::entity entity)
+	{
+		// Tiles are given their motion before being tagged, so their position is already known.
+		// It is kept on the tile since its motion may be gone by the time the tile is destroyed.
+		auto* motion = registry.try_get<Motion>(entity);
+		if (!motion)
+			return;
+		registry.get<Tile>(entity).position = motion->position;
+		int cell = GetCellIndex(motion->position);
+		if (cell >= 0)
+		{
+			m_TileGrid[cell] = entity;
+			MarkTileChunkDirty(cell);
+		}
+	}
+
+	void Scene::OnTileDestroyed(entt::registry& registry, entt::entity entity)
+	{
+		int cell = GetCellIndex(registry.get<Tile>(entity).position);
+		if (cell >= 0 && m_TileGrid[cell] == entity)
+		{
+			m_TileGrid[cell] = entt::null;
+			MarkTileChunkDirty(cell);
+		}
+	}
+
 }
@@ -6,6 +6,9 @@
 #include "Camera.h"
 #include <queue>
 #include "weather.hpp"
+#include "level_arena.hpp"
+#include "timer_queue.hpp"
+#include "command_buffer.hpp"
 
 #include <glm/vec2.hpp>
 
@@ -25,7 +28,8 @@ namespace ECS_ENTT
 		explicit Scene(std::string name, glm::vec2 size);
 		explicit Scene(std::string name, glm::vec2 size, Camera* camera);
 
-		~Scene() = default;
+		// Deletes the scene's camera and releases its arena
+		~Scene();
 
 		Entity CreateEntity(const std::string& name = std::string());
 
@@ -39,14 +43,46 @@ namespace ECS_ENTT
 
 		void SetNumPlayer(size_t n);
 
+		// Bro taking turns at the given index of the turn order, or entt::null if there is none
+		entt::entity GetRosterEntity(unsigned int order);
+
+		// Bros of the scene indexed by turn order
+		const std::pmr::vector<entt::entity>& GetRoster();
+
 		Camera* GetCamera() const { return m_Camera; }
 
+		// Memory resource for allocations that should live as long as the scene
+		LevelArena* GetArena() { return &m_Arena; }
+
+		// Memory resource for the state of entities that come and go with the scene, e.g. on restart.
+		// Freed blocks are reused, so it only grows with the most state alive at once
+		std::pmr::memory_resource* GetEntityPool() { return &m_EntityPool; }
+
 		void PointCamera(glm::vec3 position);
 		
-		std::queue<std::string> GetDialogueBoxNames();
+		const std::queue<std::string>& GetDialogueBoxNames() const;
 		
 		void PopDialogueBoxNames();
+
+		// Tile occupying a cell of the level map, or entt::null if there is none
+		entt::entity GetTile(int row, int col) const;
+
+		int GetNumRows() const { return (int)m_Map.size(); }
+		int GetNumCols() const { return m_Map.empty() ? 0 : (int)m_Map[0].size(); }
+
+		// Tiles are grouped into square chunks of TILE_CHUNK_SIZE cells, indexed row major
+		int GetNumChunkRows() const;
+		int GetNumChunkCols() const;
+
+		// A chunk is dirty when one of its tiles was created or destroyed since it was last cleaned
+		bool IsTileChunkDirty(int chunk) const { return m_DirtyTileChunks[chunk]; }
+		void CleanTileChunk(int chunk) { m_DirtyTileChunks[chunk] = false; }
 		
+	private:
+		// Declared first so that it outlives the registry and containers allocating from it
+		LevelArena m_Arena;
+		std::pmr::unsynchronized_pool_resource m_EntityPool{ &m_Arena };
+
 	public:
 		// Unique identifier of the scene
 		// Should just be the name of the level file it corresponds to
@@ -61,10 +97,16 @@ namespace ECS_ENTT
 		// Registry to contain the component data and entity IDs
 		entt::registry m_Registry;
 
+		// Timed effects of the scene's entities, see TimerSystem
+		TimerQueue m_Timers;
+
+		// Entities to destroy and components to add or remove at the end of the current step
+		CommandBuffer m_Commands;
+
 		// Size of the scene
 		glm::vec2 m_Size;
 
-		// Each scene has a camera
+		// Each scene has a camera, which it owns
 		Camera* m_Camera;
 
 		// Index of current player
@@ -81,8 +123,8 @@ namespace ECS_ENTT
 		std::string current_dialogue_box;
 
 		// Grid of entity type keys for AI path finding
-		typedef std::vector<std::string> LevelRow;
-		typedef std::vector<LevelRow> LevelMap;
+		typedef std::pmr::vector<std::string> LevelRow;
+		typedef std::pmr::vector<LevelRow> LevelMap;
 		LevelMap m_Map;
 
 		// Name of the background music used for this scene
@@ -91,6 +133,27 @@ namespace ECS_ENTT
 		WeatherTypes m_Weather;
 
 	private:
+		// Keeps the tile grid in sync with the Tile components of the registry
+		void OnTileCreated(entt::registry& registry, entt::entity entity);
+		void OnTileDestroyed(entt::registry& registry, entt::entity entity);
+
+		// Cell of the level map containing a position, or -1 if it is outside of the map
+		int GetCellIndex(glm::vec3 position) const;
+
+		void MarkTileChunkDirty(int cell);
+
+		// Bros only get their turn order after being created, so the roster is sorted the next time it is used
+		void OnRosterChanged(entt::registry& registry, entt::entity entity) { m_RosterDirty = true; }
+
+		// Tiles never move, so they are indexed by map cell (row major) to let systems
+		// look up the tiles in a region without visiting every tile of the level
+		std::pmr::vector<entt::entity> m_TileGrid;
+
+		std::pmr::vector<bool> m_DirtyTileChunks;
+
+		std::pmr::vector<entt::entity> m_Roster;
+		bool m_RosterDirty = false;
+
 		friend class Entity;
 	};
 
@@ -1,40 +1,133 @@
 #include "ai.hpp"
-#include "world.hpp"
+#include "game_instance.hpp"
+#include "entities/slingbro.hpp"
+#include "entities/projectile_pool.hpp"
 
-void AISystem::step(float elapsed_ms, vec2 window_size_in_game_units)
+#include <algorithm>
+
+void AISystem::step(GameInstance& game, float elapsed_ms, vec2 window_size_in_game_units)
 {
-	(void)window_size_in_game_units; // placeholder to silence unused warning until implemented
+	if (game.is_ai_turn) {
+		trigger_ai_movement(game.scene, true);
+		auto& registry = game.scene->m_Registry;
+
+		// The group packs the AI and Blackboard components of the enemies at the front of their pools,
+		// at the same indices. Keep enemies that share a tree next to each other so every kind is
+		// evaluated in one run. The order rarely changes, which is the best case for insertion sort.
+		auto enemies = registry.group<AI, Blackboard>(entt::get<Motion>);
+		enemies.sort<AI>([](const AI& lhs, const AI& rhs) {
+			return std::less<const BehaviorTree::Tree*>()(lhs.behavior_tree, rhs.behavior_tree);
+		}, entt::insertion_sort{});
+
+		m_BroPositions.clear();
+		registry.view<SlingBro, Motion>().each([this](const SlingBro&, const Motion& motion) {
+			m_BroPositions.push_back(motion.position);
+		});
+
+		const Camera* camera = game.scene->GetCamera();
+		vec2 halfScreen = window_size_in_game_units / 2.f;
+
+		// Start where the budget ran out last frame so every enemy gets its turn on crowded levels
+		const entt::entity* entities = enemies.data();
+		const AI* ais = enemies.raw<AI>();
+		Blackboard* blackboards = enemies.raw<Blackboard>();
+		size_t count = enemies.size();
+		size_t start = count > 0 ? m_NextTick % count : 0;
+		size_t ticks = 0;
+		std::optional<size_t> nextTick;
+
+		for (size_t n = 0; n < count; n++) {
+			size_t index = (start + n) % count;
+			entt::entity entityId = entities[index];
+			Blackboard& blackboard = blackboards[index];
+			blackboard.pendingTime += elapsed_ms;
+
+			const Motion& motion = enemies.get<Motion>(entityId);
+			if (blackboard.pendingTime < tick_interval(motion, blackboard, camera, halfScreen)) {
+				continue;
+			}
+			if (ticks == AI_MAX_TICKS_PER_FRAME) {
+				// Over budget, the elapsed time keeps accumulating until the next frame
+				if (!nextTick)
+					nextTick = index;
+				continue;
+			}
+			ticks++;
 
-	if (WorldSystem::is_ai_turn) {
-		trigger_ai_movement(true);
-		auto aiView = WorldSystem::ActiveScene->m_Registry.view<AI>();
-		for (auto entityId : aiView) {
-			auto& aiComponent = aiView.get<AI>(entityId);
-			ECS_ENTT::Entity entity = ECS_ENTT::Entity(entityId, WorldSystem::ActiveScene);
-			assert(aiComponent.behavior_tree && "AI component behavior tree should not be null");
-			BehaviorTree::State state = aiComponent.behavior_tree->process(entity, elapsed_ms);
+			const BehaviorTree::Tree* tree = ais[index].behavior_tree;
+			assert(tree && "AI component behavior tree should not be null");
+			ECS_ENTT::Entity entity = ECS_ENTT::Entity(entityId, game.scene);
+			sense(motion.position, blackboard);
+			BehaviorTree::State state = tree->process(game, entity, blackboard, blackboard.pendingTime);
+			blackboard.pendingTime = 0.f;
+			blackboard.idle = state != BehaviorTree::State::Running;
 
 			if (state == BehaviorTree::State::Successful || state == BehaviorTree::State::Failure) {
-				aiComponent.behavior_tree->init(entity);
+				tree->init(game, entity, blackboard);
 			}
 		}
+		m_NextTick = nextTick.value_or(0);
+
 		turn_countdown -= elapsed_ms;
-		if (turn_countdown < 0) {
-			trigger_ai_movement(false);
+		bool idle = turn_countdown < AI_TURN_COUNTDOWN - AI_TURN_MIN_COUNTDOWN && all_idle(game.scene);
+		if (turn_countdown < 0 || idle) {
+			trigger_ai_movement(game.scene, false);
 			turn_countdown = AI_TURN_COUNTDOWN;
-			WorldSystem::is_ai_turn = false;
+			game.is_ai_turn = false;
 		}
 	}
 }
 
-void AISystem::trigger_ai_movement(bool canMove)
+bool AISystem::all_idle(ECS_ENTT::Scene* scene) const
+{
+	auto& registry = scene->m_Registry;
+
+	// Projectiles still in flight can hit a bro
+	if (ProjectilePool::numInFlight(scene) > 0) {
+		return false;
+	}
+
+	auto blackboards = registry.view<Blackboard>();
+	return std::all_of(blackboards.raw(), blackboards.raw() + blackboards.size(), [](const Blackboard& blackboard) {
+		return blackboard.idle;
+	});
+}
+
+float AISystem::tick_interval(const Motion& motion, const Blackboard& blackboard, const Camera* camera, vec2 halfScreen) const
+{
+	// The nearest bro was sensed on the last tick, which is recent enough to pick the next one
+	if (blackboard.nearestBroDistance < AI_NEAR_DISTANCE) {
+		return 0.f;
+	}
+
+	if (!camera) {
+		return AI_FAR_TICK_INTERVAL;
+	}
+
+	vec2 offset = abs(vec2(motion.position) - vec2(camera->GetPosition()));
+	if (offset.x < halfScreen.x + SPRITE_SCALE && offset.y < halfScreen.y + SPRITE_SCALE) {
+		return 0.f;
+	}
+	return AI_FAR_TICK_INTERVAL;
+}
+
+void AISystem::sense(vec3 position, Blackboard& blackboard) const
 {
-	auto motionView = WorldSystem::ActiveScene->m_Registry.view<Motion>();
-	for (auto entityId : motionView) {
-		ECS_ENTT::Entity entity = ECS_ENTT::Entity(entityId, WorldSystem::ActiveScene);
-		if (entity.HasComponent<AI>()) {
-			auto& motionComponent = motionView.get<Motion>(entityId);
-			motionComponent.can_move = canMove;
+	blackboard.nearestBroDistance = INFINITY;
+	for (const vec3& broPosition : m_BroPositions) {
+		float dist = distance(broPosition, position);
+		if (dist < blackboard.nearestBroDistance) {
+			blackboard.nearestBroDistance = dist;
+			blackboard.nearestBro = broPosition;
 		}
 	}
 }
+
+void AISystem::trigger_ai_movement(ECS_ENTT::Scene* scene, bool canMove)
+{
+	// Only visits the kinematic bodies, not every entity with a motion
+	auto kinematicView = scene->m_Registry.view<Kinematic, Motion>();
+	for (auto entityId : kinematicView) {
+		kinematicView.get<Motion>(entityId).can_move = canMove;
+	}
+}
@@ -6,13 +6,31 @@
 
 #include "Entity.h"
 
+struct GameInstance;
+
 class AISystem
 {
 public:
-	void step(float elapsed_ms, vec2 window_size_in_game_units);
+	void step(GameInstance& game, float elapsed_ms, vec2 window_size_in_game_units);
 
 private:
-	void trigger_ai_movement(bool canMove);
+	void trigger_ai_movement(ECS_ENTT::Scene* scene, bool canMove);
+
+	// Every tree had nothing in progress on its last tick and no projectile is in flight
+	bool all_idle(ECS_ENTT::Scene* scene) const;
+
+	// Enemies near a bro or on screen tick every frame, the rest at AI_FAR_TICK_INTERVAL.
+	// Games without a camera only look at the bros.
+	float tick_interval(const Motion& motion, const Blackboard& blackboard, const Camera* camera, vec2 halfScreen) const;
+
+	// Caches the nearest bro in the blackboard so the tree's leaves don't search for it
+	void sense(vec3 position, Blackboard& blackboard) const;
 
 	float turn_countdown = AI_TURN_COUNTDOWN;
+
+	// Positions of the bros, gathered once per frame
+	std::vector<vec3> m_BroPositions;
+
+	// Index of the first enemy that didn't fit in the last frame's budget
+	size_t m_NextTick = 0;
 };
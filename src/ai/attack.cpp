@@ -1,127 +1,83 @@
 #include "attack.hpp"
-#include <world.hpp>
-#include <entities/slingbro.hpp>
+#include <game_instance.hpp>
 #include <entities/projectile.hpp>
 #include <entities/helge_projectile.hpp>
+#include <entities/projectile_pool.hpp>
 #include <particle_system.hpp>
 
-AttackInRange::AttackInRange(float dist_th) : threshold(dist_th)
+BehaviorTree::State AttackInRange::process(ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold)
 {
-
-}
-
-void AttackInRange::init(ECS_ENTT::Entity e)
-{
-
-}
-
-BehaviorTree::State AttackInRange::process(ECS_ENTT::Entity e, float elapsed_ms)
-{
-	auto slingBroView = WorldSystem::ActiveScene->m_Registry.view<SlingBro>();
-
-	for (auto slingBroEntityId : slingBroView) {
-		ECS_ENTT::Entity entity = ECS_ENTT::Entity(slingBroEntityId, WorldSystem::ActiveScene);
-		auto& slingBroMotion = entity.GetComponent<Motion>();
+	// The nearest bro is sensed once per tick by the AI system
+	if (blackboard.nearestBroDistance < threshold) {
 		auto& motion = e.GetComponent<Motion>();
-
-		double dist = distance(slingBroMotion.position, motion.position);
-
-		if (dist < threshold) {
-			motion.position.x = slingBroMotion.position.x;
-			motion.position.y = slingBroMotion.position.y;
-			return BehaviorTree::State::Successful;
-		}
+		motion.position.x = blackboard.nearestBro.x;
+		motion.position.y = blackboard.nearestBro.y;
+		return BehaviorTree::State::Successful;
 	}
 	return BehaviorTree::State::Failure;
 }
 
-ShootInRange::ShootInRange(float dist_th) : threshold(dist_th)
+BehaviorTree::State ShootInRange::process(GameInstance& game, ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold, float elapsed_ms)
 {
+	if (blackboard.nearestBroDistance >= threshold) {
+		return BehaviorTree::State::Failure;
+	}
 
-}
-
-void ShootInRange::init(ECS_ENTT::Entity e)
-{
-
-}
-
-BehaviorTree::State ShootInRange::process(ECS_ENTT::Entity e, float elapsed_ms)
-{
-	auto slingBroView = WorldSystem::ActiveScene->m_Registry.view<SlingBro>();
+	// Update countdown until next attack
+	auto& ai = e.GetComponent<AI>();
+	ai.countdown -= elapsed_ms;
 
-	for (auto slingBroEntityId : slingBroView) {
-		ECS_ENTT::Entity entity = ECS_ENTT::Entity(slingBroEntityId, WorldSystem::ActiveScene);
-		auto slingBroMotion = entity.GetComponent<Motion>();
+	// Shoot periodically
+	if (ai.countdown <= 0.f) {
 		auto& motion = e.GetComponent<Motion>();
-		double dist = distance(slingBroMotion.position, motion.position);
-
-		if (dist < threshold) {
-			// Update countdown until next attack
-			auto& ai = e.GetComponent<AI>();
-			ai.countdown -= elapsed_ms;
-
-			// Shoot periodically
-			if (ai.countdown <= 0.f) {
-				ECS_ENTT::Entity projectile = Projectile::createProjectile(motion.position, WorldSystem::ActiveScene);
-				auto& projectileMotion = projectile.GetComponent<Motion>();
+		// Hold fire while the level is at its projectile cap
+		if (auto projectile = ProjectilePool::acquireProjectile(motion.position, game.scene))
+		{
+			auto& projectileMotion = projectile->GetComponent<Motion>();
 
-				vec3 displacement = slingBroMotion.position - motion.position;
-				projectileMotion.angle = atan2(displacement.y, displacement.x) + Random::Float();
+			vec3 displacement = blackboard.nearestBro - motion.position;
+			projectileMotion.angle = atan2(displacement.y, displacement.x) + game.random.Float();
 
-				vec3 normalizedDisplacement = normalize(displacement);
-				projectileMotion.velocity.x = normalizedDisplacement.x * PROJECTILE_SPEED_MULTIPLIER + (PROJECTILE_AIM_RANDOMNESS_FACTOR * (0.5f - Random::Float()));
-				projectileMotion.velocity.y = normalizedDisplacement.y * PROJECTILE_SPEED_MULTIPLIER + (PROJECTILE_AIM_RANDOMNESS_FACTOR * (0.5f - Random::Float()));
-
-				// Reset the attack countdown
-				ai.countdown = AI_ACTION_COUNTDOWN;
-			}
-			return BehaviorTree::State::Successful;
+			vec3 normalizedDisplacement = normalize(displacement);
+			projectileMotion.velocity.x = normalizedDisplacement.x * PROJECTILE_SPEED_MULTIPLIER + (PROJECTILE_AIM_RANDOMNESS_FACTOR * (0.5f - game.random.Float()));
+			projectileMotion.velocity.y = normalizedDisplacement.y * PROJECTILE_SPEED_MULTIPLIER + (PROJECTILE_AIM_RANDOMNESS_FACTOR * (0.5f - game.random.Float()));
 		}
-	}
-	return BehaviorTree::State::Failure;
-}
-
-HelgeShootInRange::HelgeShootInRange(float dist_th) : threshold(dist_th)
-{
 
+		// Reset the attack countdown
+		ai.countdown = AI_ACTION_COUNTDOWN;
+		return BehaviorTree::State::Successful;
+	}
+	// Still waiting to fire, which keeps the AI turn going
+	return BehaviorTree::State::Running;
 }
 
-void HelgeShootInRange::init(ECS_ENTT::Entity e)
+BehaviorTree::State HelgeShootInRange::process(GameInstance& game, ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold, float elapsed_ms)
 {
+	if (blackboard.nearestBroDistance >= threshold) {
+		return BehaviorTree::State::Failure;
+	}
 
-}
+	// Update countdown until next attack
+	auto& ai = e.GetComponent<AI>();
+	ai.countdown -= elapsed_ms;
 
-BehaviorTree::State HelgeShootInRange::process(ECS_ENTT::Entity e, float elapsed_ms) 
-{
-	auto slingBroView = WorldSystem::ActiveScene->m_Registry.view<SlingBro>();
-
-	for (auto slingBroEntityId : slingBroView) {
-		ECS_ENTT::Entity entity = ECS_ENTT::Entity(slingBroEntityId, WorldSystem::ActiveScene);
-		auto slingBroMotion = entity.GetComponent<Motion>();
+	// Shoot periodically
+	if (ai.countdown <= 0.f) {
 		auto& motion = e.GetComponent<Motion>();
-		double dist = distance(slingBroMotion.position, motion.position);
-
-		if (dist < threshold) {
-			// Update countdown until next attack
-			auto& ai = e.GetComponent<AI>();
-			ai.countdown -= elapsed_ms;
+		if (auto projectile = ProjectilePool::acquireHelgeProjectile(motion.position, game.scene))
+		{
+			auto& projectileMotion = projectile->GetComponent<Motion>();
 
-			// Shoot periodically
-			if (ai.countdown <= 0.f) {
-				ECS_ENTT::Entity projectile = HelgeProjectile::createHelgeProjectile(motion.position, WorldSystem::ActiveScene);
-				auto& projectileMotion = projectile.GetComponent<Motion>();
+			vec3 displacement = blackboard.nearestBro - motion.position;
 
-				vec3 displacement = slingBroMotion.position - motion.position;
-
-				vec3 normalizedDisplacement = normalize(displacement);
-				projectileMotion.velocity.x = normalizedDisplacement.x * HELGE_PROJECTILE_SPEED_MULTIPLIER;
-				projectileMotion.velocity.y = normalizedDisplacement.y * HELGE_PROJECTILE_SPEED_MULTIPLIER;
-
-				// Reset the attack countdown
-				ai.countdown = 1000.f;
-			}
-			return BehaviorTree::State::Successful;
+			vec3 normalizedDisplacement = normalize(displacement);
+			projectileMotion.velocity.x = normalizedDisplacement.x * HELGE_PROJECTILE_SPEED_MULTIPLIER;
+			projectileMotion.velocity.y = normalizedDisplacement.y * HELGE_PROJECTILE_SPEED_MULTIPLIER;
 		}
+
+		// Reset the attack countdown
+		ai.countdown = 1000.f;
+		return BehaviorTree::State::Successful;
 	}
-	return BehaviorTree::State::Failure;
+	return BehaviorTree::State::Running;
 }
@@ -1,46 +1,24 @@
 #pragma once
 
+#include <common.hpp>
 #include "behavioral_tree.hpp"
 
 const size_t MAX_PROJECTILES = 10;
 const size_t PROJECTILE_SPEED_MULTIPLIER = 100;
 const size_t HELGE_PROJECTILE_SPEED_MULTIPLIER = 250;
 
-class AttackInRange : public BehaviorTree::Node
+// Leaf nodes are stateless, the tree passes in the node's range and the bro sensed for this tick
+struct AttackInRange
 {
-public:
-	AttackInRange(float dist_th);
-
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-	float threshold;
+	static BehaviorTree::State process(ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold);
 };
 
-class ShootInRange : public BehaviorTree::Node
+struct ShootInRange
 {
-public:
-	ShootInRange(float dist_th);
-
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-	float threshold;
+	static BehaviorTree::State process(GameInstance& game, ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold, float elapsed_ms);
 };
 
-class HelgeShootInRange : public BehaviorTree::Node
+struct HelgeShootInRange
 {
-public:
-	HelgeShootInRange(float dist_th);
-
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-	float threshold;
-};
\ No newline at end of file
+	static BehaviorTree::State process(GameInstance& game, ECS_ENTT::Entity e, const Blackboard& blackboard, float threshold, float elapsed_ms);
+};
@@ -1,85 +1,104 @@
 #include "behavioral_tree.hpp"
+#include "attack.hpp"
+#include "movement.hpp"
+#include "pathfinding.hpp"
 
 namespace BehaviorTree
 {
-	Sequence::Sequence(std::vector<Node*> children)
-			: m_index(0), m_children(std::move(children))
+	Tree::Tree(std::vector<NodeDef> nodes)
+			: m_nodes(std::move(nodes))
 	{
-
+		assert(!m_nodes.empty() && m_nodes.size() <= MAX_TREE_NODES);
 	}
 
-	void Sequence::init(ECS_ENTT::Entity e)
+	Tree Tree::Leaf(NodeType type, float param)
 	{
-		m_index = 0;
-		assert(m_index < m_children.size());
-		const auto& child = m_children[m_index];
-		assert(child);
-		child->init(e);
+		return Tree({ { type, param } });
 	}
 
-	State Sequence::process(ECS_ENTT::Entity e, float elapsed_ms)
+	Tree Tree::Composite(NodeType type, const std::vector<NodeDef>& children)
 	{
-		assert(m_index < m_children.size());
-		const auto& child = m_children[m_index];
-		assert(child);
-		State state = child->process(e, elapsed_ms);
-
-		if (state == State::Successful) {
-			++m_index;
-			if (m_index >= m_children.size()) {
-				// Succeed if all children have succeeded
-				return State::Successful;
-			} else {
-				const auto& nextChild = m_children[m_index];
-				assert(nextChild);
-				nextChild->init(e);
-				return State::Running;
-			}
-		} else {
-			return state;
-		}
+		assert(type == NodeType::Sequence || type == NodeType::Selector);
+		std::vector<NodeDef> nodes = { { type, 0.f, 1, (uint8_t)children.size() } };
+		nodes.insert(nodes.end(), children.begin(), children.end());
+		return Tree(std::move(nodes));
 	}
 
-	Selector::Selector(std::vector<Node*> children)
-			: m_index(0), m_children(std::move(children))
+	void Tree::init(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard, uint8_t node) const
 	{
+		assert(node < m_nodes.size());
+		const NodeDef& def = m_nodes[node];
 
+		switch (def.type)
+		{
+		case NodeType::Sequence:
+		case NodeType::Selector:
+			assert(def.numChildren > 0);
+			blackboard.childIndex[node] = 0;
+			init(game, e, blackboard, def.firstChild);
+			break;
+		case NodeType::MoveToGoal:
+			MoveToGoal::init(game, e, blackboard);
+			break;
+		default:
+			// The remaining leaves have nothing to set up
+			break;
+		}
 	}
 
-	void Selector::init(ECS_ENTT::Entity e)
+	State Tree::process(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard, float elapsed_ms, uint8_t node) const
 	{
-		m_index = 0;
-		assert(m_index < m_children.size());
-		const auto& child = m_children[m_index];
-		assert(child);
-		child->init(e);
-	}
+		assert(node < m_nodes.size());
+		const NodeDef& def = m_nodes[node];
 
-	State Selector::process(ECS_ENTT::Entity e, float elapsed_ms)
-	{
-		assert(m_index < m_children.size());
-		const auto& child = m_children[m_index];
-		assert(child);
-		State state = child->process(e, elapsed_ms);
+		switch (def.type)
+		{
+		case NodeType::Sequence:
+		{
+			uint8_t& index = blackboard.childIndex[node];
+			assert(index < def.numChildren);
+			State state = process(game, e, blackboard, elapsed_ms, def.firstChild + index);
 
-		if (state == State::Successful) {
-			// Succeed if any of the children succeed
-			return State::Successful;
-		}
+			if (state != State::Successful)
+				return state;
 
-		if (state == State::Running) {
-			return state;
+			++index;
+			if (index >= def.numChildren) {
+				// Succeed if all children have succeeded
+				return State::Successful;
+			}
+			init(game, e, blackboard, def.firstChild + index);
+			return State::Running;
 		}
+		case NodeType::Selector:
+		{
+			uint8_t& index = blackboard.childIndex[node];
+			assert(index < def.numChildren);
+			State state = process(game, e, blackboard, elapsed_ms, def.firstChild + index);
+
+			// Succeed if any of the children succeed
+			if (state != State::Failure)
+				return state;
 
-		// state is State::Failure
-		m_index++;
-		if (m_index < m_children.size()) {
-			const auto& nextChild = m_children[m_index];
-			assert(nextChild);
-			nextChild->init(e);
+			++index;
+			if (index >= def.numChildren)
+				return State::Failure;
+			init(game, e, blackboard, def.firstChild + index);
 			return State::Running;
-		} else {
-			return State::Failure;
 		}
+		case NodeType::AttackInRange:
+			return AttackInRange::process(e, blackboard, def.param);
+		case NodeType::ShootInRange:
+			return ShootInRange::process(game, e, blackboard, def.param, elapsed_ms);
+		case NodeType::HelgeShootInRange:
+			return HelgeShootInRange::process(game, e, blackboard, def.param, elapsed_ms);
+		case NodeType::Patrol:
+			return Patrol::process(e, blackboard, (int)def.param, elapsed_ms);
+		case NodeType::SkyPatrol:
+			return SkyPatrol::process(e, blackboard, (int)def.param, elapsed_ms);
+		case NodeType::MoveToGoal:
+			return MoveToGoal::process(e, blackboard);
+		}
+		return State::Failure;
 	}
 }
@@ -1,7 +1,13 @@
 #pragma once
 
+#include <cstdint>
+#include <vector>
+
 #include "Entity.h"
 
+struct Blackboard;
+struct GameInstance;
+
 namespace BehaviorTree
 {
 	enum class State
@@ -11,44 +17,51 @@ namespace BehaviorTree
 		Failure
 	};
 
-	class Node
+	enum class NodeType : uint8_t
 	{
-	public:
-		virtual ~Node() noexcept = default;
+		// Composite node that succeeds when ALL children succeed
+		Sequence,
+		// Composite node that succeeds when ANY children succeeds
+		Selector,
+		AttackInRange,
+		ShootInRange,
+		HelgeShootInRange,
+		Patrol,
+		SkyPatrol,
+		MoveToGoal
+	};
 
-		virtual void init(ECS_ENTT::Entity e)
-		{};
+	// Composites keep their current child in the entity's blackboard, so trees stay this small
+	const size_t MAX_TREE_NODES = 8;
 
-		virtual State process(ECS_ENTT::Entity e, float elapsed_ms) = 0;
+	struct NodeDef
+	{
+		NodeType type;
+		// Range of a shooting node, or steps before turning of a patrol node
+		float param = 0.f;
+		// Children of a composite node are stored next to each other in the tree
+		uint8_t firstChild = 0;
+		uint8_t numChildren = 0;
 	};
 
-	// Composite node that succeeds when ALL children succeed
-	class Sequence : public Node
+	// Immutable behavior tree shared by every enemy of the same kind, the root is the first node.
+	// All per-entity state lives in the entity's Blackboard component.
+	class Tree
 	{
 	public:
-		Sequence(std::vector<Node*> children);
+		Tree(std::vector<NodeDef> nodes);
 
-	private:
-		void init(ECS_ENTT::Entity e) override;
+		// Tree made of a single leaf node
+		static Tree Leaf(NodeType type, float param = 0.f);
 
-		State process(ECS_ENTT::Entity e, float elapsed_ms) override;
+		// Tree whose root is a composite of the given leaf nodes
+		static Tree Composite(NodeType type, const std::vector<NodeDef>& children);
 
-		size_t m_index;
-		std::vector<Node*> m_children;
-	};
+		void init(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard, uint8_t node = 0) const;
 
-	// Composite node that succeeds when ANY children succeeds
-	class Selector : public Node
-	{
-	public:
-		Selector(std::vector<Node*> children);
+		State process(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard, float elapsed_ms, uint8_t node = 0) const;
 
 	private:
-		void init(ECS_ENTT::Entity e) override;
-
-		State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-		size_t m_index;
-		std::vector<Node*> m_children;
+		std::vector<NodeDef> m_nodes;
 	};
 }
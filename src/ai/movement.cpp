@@ -1,42 +1,26 @@
 #include "movement.hpp"
 
-Patrol::Patrol(int stepsBeforeTurn) : stepsBeforeTurn(stepsBeforeTurn), n(stepsBeforeTurn)
-{
-
-}
-
-void Patrol::init(ECS_ENTT::Entity e)
-{
-
-}
-
-BehaviorTree::State Patrol::process(ECS_ENTT::Entity e, float elapsed_ms)
+BehaviorTree::State Patrol::process(ECS_ENTT::Entity e, Blackboard& blackboard, int stepsBeforeTurn, float elapsed_ms)
 {
 	auto& motion = e.GetComponent<Motion>();
 
-	if (--n == 0) {
+	blackboard.patrolTime += elapsed_ms;
+	while (blackboard.patrolTime >= stepsBeforeTurn * AI_PATROL_STEP) {
 		motion.velocity.x *= -1;
-		n = stepsBeforeTurn;
+		blackboard.patrolTime -= stepsBeforeTurn * AI_PATROL_STEP;
 	}
 
 	return BehaviorTree::State::Successful;
 }
 
-SkyPatrol::SkyPatrol(int stepsBeforeTurn) : stepsBeforeTurn(stepsBeforeTurn), n(stepsBeforeTurn) {
-
-}
-
-void SkyPatrol::init(ECS_ENTT::Entity e) {
-
-}
-
-BehaviorTree::State SkyPatrol::process(ECS_ENTT::Entity e, float elapsed_ms) {
+BehaviorTree::State SkyPatrol::process(ECS_ENTT::Entity e, Blackboard& blackboard, int stepsBeforeTurn, float elapsed_ms) {
 	auto& motion = e.GetComponent<Motion>();
 
-	if (--n == 0) {
+	blackboard.patrolTime += elapsed_ms;
+	while (blackboard.patrolTime >= stepsBeforeTurn * AI_PATROL_STEP) {
 		motion.velocity.y *= -1;
-		n = stepsBeforeTurn;
+		blackboard.patrolTime -= stepsBeforeTurn * AI_PATROL_STEP;
 	}
 
 	return BehaviorTree::State::Successful;
-}
\ No newline at end of file
+}
@@ -3,28 +3,12 @@
 #include <common.hpp>
 #include "behavioral_tree.hpp"
 
-class Patrol : public BehaviorTree::Node {
-public:
-	Patrol(int stepsBeforeTurn);
-
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-	int stepsBeforeTurn;
-	int n;
+// Turns around every stepsBeforeTurn steps of AI_PATROL_STEP, timed in the entity's blackboard
+// so enemies that tick less often still turn at the same places
+struct Patrol {
+	static BehaviorTree::State process(ECS_ENTT::Entity e, Blackboard& blackboard, int stepsBeforeTurn, float elapsed_ms);
 };
 
-class SkyPatrol : public BehaviorTree::Node {
-public:
-	SkyPatrol(int stepsBeforeTurn);
-
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-
-	int stepsBeforeTurn;
-	int n;
+struct SkyPatrol {
+	static BehaviorTree::State process(ECS_ENTT::Entity e, Blackboard& blackboard, int stepsBeforeTurn, float elapsed_ms);
 };
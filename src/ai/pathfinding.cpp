@@ -5,23 +5,19 @@
 #include <entities/goal_tile.hpp>
 #include <iostream>
 #include "pathfinding.hpp"
-#include "world.hpp"
+#include "game_instance.hpp"
 #include <loader/level_manager.hpp>
 
-MoveToGoal::MoveToGoal() : m_GoalReached(false)
+void MoveToGoal::init(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard)
 {
-
-}
-
-void MoveToGoal::init(ECS_ENTT::Entity e)
-{
-	if (m_GoalReached) {
+	if (blackboard.goalReached) {
 		return;
 	}
 	// Perform BFS to find the shortest path to goal position
 
-	int rows = WorldSystem::GameScene->m_Map.size();
-	int cols = WorldSystem::GameScene->m_Map[0].size();
+	const ECS_ENTT::Scene* scene = game.scene;
+	int rows = scene->m_Map.size();
+	int cols = scene->m_Map[0].size();
 
 	// 2d matrix to store whether or not we visited a node already
 	bool* visited = new bool[rows * cols];
@@ -47,16 +43,19 @@ void MoveToGoal::init(ECS_ENTT::Entity e)
 		vec2 nodePositionIndices = {nodePosition.x / SPRITE_SCALE, nodePosition.y / SPRITE_SCALE};
 		pathQueue.pop();
 
-		std::string test_e = WorldSystem::GameScene->m_Map[(int) nodePositionIndices.y][(int) nodePositionIndices.x];
+		std::string test_e = scene->m_Map[(int) nodePositionIndices.y][(int) nodePositionIndices.x];
 
 		if (isGoalTile(test_e)) {
-			m_Path = test_path;
-			m_GoalReached = true;
+			blackboard.path.clear();
+			blackboard.pathIndex = 0;
+			for (; !test_path.empty(); test_path.pop())
+				blackboard.path.push_back(test_path.front());
+			blackboard.goalReached = true;
 			delete[] visited;
 			return;
 		}
 		// if we run into a tile or if there is no ground around this space, stop exploring this path
-		if (isTile(test_e) || isFloating(nodePositionIndices.y, nodePositionIndices.x)) {
+		if (isTile(test_e) || isFloating(scene, nodePositionIndices.y, nodePositionIndices.x)) {
 			continue;
 		}
 
@@ -65,7 +64,7 @@ void MoveToGoal::init(ECS_ENTT::Entity e)
 							 nodePosition.y + (direction.y * SPRITE_SCALE)};
 			vec2 new_node_indices = nodePositionIndices + direction;
 
-			if (outOfMapRange(new_node_indices.y, new_node_indices.x)) {
+			if (outOfMapRange(scene, new_node_indices.y, new_node_indices.x)) {
 				continue;
 			}
 
@@ -81,9 +80,9 @@ void MoveToGoal::init(ECS_ENTT::Entity e)
 	delete[] visited;
 }
 
-BehaviorTree::State MoveToGoal::process(ECS_ENTT::Entity e, float elapsed_ms)
+BehaviorTree::State MoveToGoal::process(ECS_ENTT::Entity e, Blackboard& blackboard)
 {
-	if (m_Path.empty()) {
+	if (blackboard.pathIndex >= blackboard.path.size()) {
 		return BehaviorTree::State::Successful;
 	}
 
@@ -91,13 +90,15 @@ BehaviorTree::State MoveToGoal::process(ECS_ENTT::Entity e, float elapsed_ms)
 	auto& motion = e.GetComponent<Motion>();
 	auto position = motion.position;
 	auto source = vec2(position);      // Initial x,y position of the AI
-	auto destination = m_Path.front(); // x,y position of the next tile to move towards
+	auto destination = blackboard.path[blackboard.pathIndex]; // x,y position of the next tile to move towards
 
 	// Already at destination
 	if (source.x == destination.x && source.y == destination.y) {
 		// Finished moving to target tile so remove from path
-		m_Path.pop();
-		destination = m_Path.front();
+		if (++blackboard.pathIndex >= blackboard.path.size()) {
+			return BehaviorTree::State::Successful;
+		}
+		destination = blackboard.path[blackboard.pathIndex];
 
 		// Set the next intermediate target destination
 		auto& ai = e.GetComponent<AI>();
@@ -116,27 +117,27 @@ BehaviorTree::State MoveToGoal::process(ECS_ENTT::Entity e, float elapsed_ms)
 	return BehaviorTree::State::Running;
 }
 
-bool MoveToGoal::isGoalTile(std::string s)
+bool MoveToGoal::isGoalTile(const std::string& s)
 {
 	return s == T1;
 }
 
-bool MoveToGoal::isTile(std::string s)
+bool MoveToGoal::isTile(const std::string& s)
 {
 	return s == T2 || s == T3 || s == T4 || s == T6 || s == T7 || s == H0 || s == H1;
 }
 
-bool MoveToGoal::isFloating(int y, int x)
+bool MoveToGoal::isFloating(const ECS_ENTT::Scene* scene, int y, int x)
 {
 	for (vec2 direction : BFS_DIRECTIONS) {
 		int test_y = y + (int) direction.y;
 		int test_x = x + (int) direction.x;
 
-		if (outOfMapRange(test_y, test_x)) {
+		if (outOfMapRange(scene, test_y, test_x)) {
 			continue;
 		}
 
-		std::string test_e = WorldSystem::GameScene->m_Map[test_y][test_x];
+		std::string test_e = scene->m_Map[test_y][test_x];
 		// if there is a ground based tile around this position, the snail has a way to traverse to it
 		if (isTile(test_e)) {
 			return false;
@@ -145,10 +146,10 @@ bool MoveToGoal::isFloating(int y, int x)
 	return true;
 }
 
-bool MoveToGoal::outOfMapRange(int y, int x)
+bool MoveToGoal::outOfMapRange(const ECS_ENTT::Scene* scene, int y, int x)
 {
-	int rows = WorldSystem::GameScene->m_Map.size();
-	int cols = WorldSystem::GameScene->m_Map[0].size();
+	int rows = scene->m_Map.size();
+	int cols = scene->m_Map[0].size();
 
 	return y >= rows || x >= cols || y < 0 || x < 0;
 }
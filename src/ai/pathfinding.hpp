@@ -18,20 +18,17 @@ static const vec2 BFS_DIRECTIONS[] = {
 		vec2(-1.0, -1.0)
 };
 
-class MoveToGoal : public BehaviorTree::Node
+// Walks the entity along the shortest path to the goal tile, the path is kept in its blackboard
+class MoveToGoal
 {
 public:
-	MoveToGoal();
+	static void init(GameInstance& game, ECS_ENTT::Entity e, Blackboard& blackboard);
 
-private:
-	void init(ECS_ENTT::Entity e) override;
-
-	BehaviorTree::State process(ECS_ENTT::Entity e, float elapsed_ms) override;
-	bool isGoalTile(std::string s);
-	bool isTile(std::string s);
-	bool isFloating(int y, int x);
-	bool outOfMapRange(int y, int x);
+	static BehaviorTree::State process(ECS_ENTT::Entity e, Blackboard& blackboard);
 
-	std::queue<vec2> m_Path;
-	bool m_GoalReached;
+private:
+	static bool isGoalTile(const std::string& s);
+	static bool isTile(const std::string& s);
+	static bool isFloating(const ECS_ENTT::Scene* scene, int y, int x);
+	static bool outOfMapRange(const ECS_ENTT::Scene* scene, int y, int x);
 };
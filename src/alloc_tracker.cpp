@@ -0,0 +1,161 @@
+#include "alloc_tracker.hpp"
+
+#ifdef SLINGBROS_TRACK_ALLOCATIONS
+
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+namespace
+{
+	// Consecutive settled frames before they have to stop allocating, e.g. draw lists grow to
+	// their working size during the first frames after a turn or a level change
+	const int WARMUP_FRAMES = 120;
+	// Frames between two reports of allocating settled frames outside of the test mode
+	const int REPORT_INTERVAL_FRAMES = 60;
+
+	const char* TAG_NAMES[] = { "other", "ai", "world", "particles", "physics", "animation", "render" };
+	static_assert(sizeof(TAG_NAMES) / sizeof(TAG_NAMES[0]) == (size_t)AllocTag::Count, "Every tag needs a name");
+
+	// Workers of a game batch allocate too, hence the atomics
+	std::atomic<uint64_t> s_Allocations[(size_t)AllocTag::Count];
+	std::atomic<uint64_t> s_Bytes[(size_t)AllocTag::Count];
+
+	thread_local AllocTag t_Tag = AllocTag::Other;
+
+	int s_SettledFrames = 0;
+	int s_FramesSinceReport = REPORT_INTERVAL_FRAMES;
+	const bool s_AssertZero = std::getenv("SLINGBROS_ASSERT_ZERO_ALLOC") != nullptr;
+
+	void* allocate(size_t bytes)
+	{
+		AllocTracker::Record(bytes);
+		// malloc(0) may return null, operator new may not
+		if (void* p = std::malloc(bytes ? bytes : 1))
+			return p;
+		throw std::bad_alloc();
+	}
+
+	void* allocate_aligned(size_t bytes, std::align_val_t alignment)
+	{
+		AllocTracker::Record(bytes);
+		size_t align = (size_t)alignment;
+#ifdef _WIN32
+		void* p = _aligned_malloc(bytes ? bytes : 1, align);
+#else
+		// aligned_alloc wants the size to be a multiple of the alignment
+		void* p = std::aligned_alloc(align, (bytes + align - 1) / align * align);
+#endif
+		if (p)
+			return p;
+		throw std::bad_alloc();
+	}
+
+	void free_aligned(void* p)
+	{
+#ifdef _WIN32
+		_aligned_free(p);
+#else
+		std::free(p);
+#endif
+	}
+
+	void report(const char* reason)
+	{
+		fprintf(stderr, "%s:", reason);
+		for (size_t i = 0; i < (size_t)AllocTag::Count; i++)
+		{
+			AllocTracker::Counts counts = AllocTracker::Frame((AllocTag)i);
+			if (counts.allocations > 0)
+				fprintf(stderr, " %s %llu (%llu bytes)", TAG_NAMES[i], (unsigned long long)counts.allocations, (unsigned long long)counts.bytes);
+		}
+		fprintf(stderr, "\n");
+	}
+}
+
+AllocTracker::Scope::Scope(AllocTag tag)
+		: m_Previous(t_Tag)
+{
+	t_Tag = tag;
+}
+
+AllocTracker::Scope::~Scope()
+{
+	t_Tag = m_Previous;
+}
+
+void AllocTracker::Record(size_t bytes)
+{
+	size_t tag = (size_t)t_Tag;
+	s_Allocations[tag].fetch_add(1, std::memory_order_relaxed);
+	s_Bytes[tag].fetch_add(bytes, std::memory_order_relaxed);
+}
+
+void AllocTracker::BeginFrame()
+{
+	for (size_t i = 0; i < (size_t)AllocTag::Count; i++)
+	{
+		s_Allocations[i].store(0, std::memory_order_relaxed);
+		s_Bytes[i].store(0, std::memory_order_relaxed);
+	}
+}
+
+void AllocTracker::EndFrame(bool settled)
+{
+	s_SettledFrames = settled ? s_SettledFrames + 1 : 0;
+	s_FramesSinceReport++;
+	if (s_SettledFrames <= WARMUP_FRAMES)
+		return;
+
+	uint64_t allocations = 0;
+	for (size_t i = 0; i < (size_t)AllocTag::Count; i++)
+		allocations += Frame((AllocTag)i).allocations;
+	if (allocations == 0)
+		return;
+
+	if (s_AssertZero)
+	{
+		report("Settled frame allocated");
+		std::abort();
+	}
+	if (s_FramesSinceReport >= REPORT_INTERVAL_FRAMES)
+	{
+		report("Settled frame allocated");
+		s_FramesSinceReport = 0;
+	}
+}
+
+AllocTracker::Counts AllocTracker::Frame(AllocTag tag)
+{
+	return { s_Allocations[(size_t)tag].load(std::memory_order_relaxed), s_Bytes[(size_t)tag].load(std::memory_order_relaxed) };
+}
+
+// Every form of new and delete is replaced, so no allocation of the program slips past the counters
+void* operator new(size_t bytes) { return allocate(bytes); }
+void* operator new[](size_t bytes) { return allocate(bytes); }
+void* operator new(size_t bytes, const std::nothrow_t&) noexcept
+{
+	try { return allocate(bytes); }
+	catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new[](size_t bytes, const std::nothrow_t&) noexcept
+{
+	try { return allocate(bytes); }
+	catch (const std::bad_alloc&) { return nullptr; }
+}
+void* operator new(size_t bytes, std::align_val_t alignment) { return allocate_aligned(bytes, alignment); }
+void* operator new[](size_t bytes, std::align_val_t alignment) { return allocate_aligned(bytes, alignment); }
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete[](void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
+void operator delete[](void* p, size_t) noexcept { std::free(p); }
+void operator delete(void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete[](void* p, const std::nothrow_t&) noexcept { std::free(p); }
+void operator delete(void* p, std::align_val_t) noexcept { free_aligned(p); }
+void operator delete[](void* p, std::align_val_t) noexcept { free_aligned(p); }
+void operator delete(void* p, size_t, std::align_val_t) noexcept { free_aligned(p); }
+void operator delete[](void* p, size_t, std::align_val_t) noexcept { free_aligned(p); }
+
+#endif
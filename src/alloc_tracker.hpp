@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+// Systems the heap allocations of a frame are attributed to
+enum class AllocTag : uint8_t
+{
+	Other,
+	AI,
+	World,
+	Particles,
+	Physics,
+	Animation,
+	Render,
+	Count
+};
+
+// Counts every heap allocation when the game is configured with -DSLINGBROS_TRACK_ALLOCATIONS=ON, which
+// replaces the global operator new. Without it everything here compiles away.
+//
+// A frame the player is just aiming in should not allocate at all. Setting the SLINGBROS_ASSERT_ZERO_ALLOC
+// environment variable turns that into a test: the game aborts with a report of the first settled frame
+// that allocates. Otherwise such frames are reported at most once a second.
+class AllocTracker
+{
+public:
+	struct Counts
+	{
+		uint64_t allocations = 0;
+		uint64_t bytes = 0;
+	};
+
+	// Allocations are attributed to the innermost scope on the allocating thread
+	class Scope
+	{
+	public:
+#ifdef SLINGBROS_TRACK_ALLOCATIONS
+		explicit Scope(AllocTag tag);
+		~Scope();
+
+	private:
+		AllocTag m_Previous;
+#else
+		explicit Scope(AllocTag) {}
+#endif
+	};
+
+#ifdef SLINGBROS_TRACK_ALLOCATIONS
+	static void Record(size_t bytes);
+
+	static void BeginFrame();
+
+	// Ends the frame, a frame is settled when nothing but the player's input can change what it allocates
+	static void EndFrame(bool settled);
+
+	static Counts Frame(AllocTag tag);
+#else
+	static void BeginFrame() {}
+
+	static void EndFrame(bool) {}
+
+	static Counts Frame(AllocTag) { return {}; }
+#endif
+};
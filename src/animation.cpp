@@ -3,14 +3,10 @@
 
 void AnimationSystem::step(float elapsed_ms, ECS_ENTT::Scene* activeScene)
 {
-	// Cycle through all entities with an Animation component and update timers / frames
-	auto animationEntitiesView = activeScene->m_Registry.view<Animation>();
-	for (entt::entity entityID : animationEntitiesView)
-	{
-		ECS_ENTT::Entity animationEntity = ECS_ENTT::Entity(entityID, activeScene);
-		Animation& animComponent = animationEntity.GetComponent<Animation>();
+	// Cycle through all Animation components and update timers / frames
+	activeScene->m_Registry.view<Animation>().each([elapsed_ms](Animation& animComponent) {
 		animComponent.step(elapsed_ms);
-	}
+	});
 }
 
 // Collisions between wall and non-wall entities - callback function, listening to PhysicsSystem::Collisions
@@ -9,7 +9,7 @@
 
 struct Animation
 {
-	std::string cacheResourceKey;
+	ResourceHandle meshHandle;		// the cached mesh whose texture coordinates are animated
 	glm::vec2 baseAnimStartOffset;		// the spritesheet off of the idle / regular animation
 	glm::vec2 currentAnimStartOffset;	// the spritesheet offset of the active animation
 	int baseNumFrames = 2;			// number of frames for the idle / regular animation
@@ -20,8 +20,8 @@ struct Animation
 	bool hasCollisionAnimation = false;
 	bool playingCollisionAnimation = false;
 
-	Animation(std::string cacheResourceKey, glm::vec2 animStartOffset, int numAnimationFrames, float frameDisplayTimeMs, bool hasCollisionAnimation)
-		: cacheResourceKey(cacheResourceKey), baseAnimStartOffset(animStartOffset), currentAnimStartOffset(baseAnimStartOffset), 
+	Animation(ResourceHandle meshHandle, glm::vec2 animStartOffset, int numAnimationFrames, float frameDisplayTimeMs, bool hasCollisionAnimation)
+		: meshHandle(meshHandle), baseAnimStartOffset(animStartOffset), currentAnimStartOffset(baseAnimStartOffset), 
 		baseNumFrames(numAnimationFrames), currentNumFrames(baseNumFrames), frameLengthMs(frameDisplayTimeMs), hasCollisionAnimation(hasCollisionAnimation)
 	{}
 
@@ -49,7 +49,7 @@ struct Animation
 
 			// Progress to the next frame in the animation
 			glm::vec2 spritesheetOffset(currentAnimStartOffset.x + currentFrameNumber, currentAnimStartOffset.y);
-			ShadedMesh& shadedMesh = cache_resource(cacheResourceKey);
+			ShadedMesh& shadedMesh = ResourceCache::get(meshHandle);
 			glBindVertexArray(*shadedMesh.mesh.vao.data());
 			TexturedVertex vertices[4];
 			vertices[0].position = { -1.f / 2, +1.f / 2, 0.f };
@@ -0,0 +1,46 @@
+#include "command_buffer.hpp"
+
+#include <algorithm>
+
+void CommandBuffer::destroy(entt::entity entity)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Destroyed.push_back(entity);
+}
+
+void CommandBuffer::create(std::function<void(entt::registry& registry, entt::entity entity)> init)
+{
+	record([init = std::move(init)](entt::registry& registry) {
+		init(registry, registry.create());
+	});
+}
+
+void CommandBuffer::record(Command command)
+{
+	std::lock_guard<std::mutex> lock(m_Mutex);
+	m_Commands.push_back(std::move(command));
+}
+
+void CommandBuffer::flush(entt::registry& registry)
+{
+	// Whatever the commands record is left for the next flush
+	{
+		std::lock_guard<std::mutex> lock(m_Mutex);
+		std::swap(m_Commands, m_Flushing);
+		std::swap(m_Destroyed, m_FlushingDestroyed);
+	}
+
+	for (auto& command : m_Flushing)
+		command(registry);
+	m_Flushing.clear();
+
+	if (m_FlushingDestroyed.empty())
+		return;
+
+	auto id_order = [](entt::entity a, entt::entity b) { return entt::to_integral(a) < entt::to_integral(b); };
+	std::sort(m_FlushingDestroyed.begin(), m_FlushingDestroyed.end(), id_order);
+	auto last = std::unique(m_FlushingDestroyed.begin(), m_FlushingDestroyed.end());
+	last = std::remove_if(m_FlushingDestroyed.begin(), last, [&registry](entt::entity entity) { return !registry.valid(entity); });
+	registry.destroy(m_FlushingDestroyed.begin(), last);
+	m_FlushingDestroyed.clear();
+}
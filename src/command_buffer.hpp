@@ -0,0 +1,55 @@
+#pragma once
+
+#include "entt.hpp"
+
+#include <functional>
+#include <mutex>
+#include <vector>
+
+// Structural changes to a scene's registry recorded while systems iterate it, e.g. by collision
+// listeners, and applied together at the end of the step. Until then every entity and component
+// stays where it is, so views aren't disturbed. Recording is safe from any thread.
+class CommandBuffer
+{
+public:
+	using Command = std::function<void(entt::registry& registry)>;
+
+	// Destroys the entity at the next flush, recording it more than once is fine
+	void destroy(entt::entity entity);
+
+	// Creates an entity at the next flush and hands it to the initializer
+	void create(std::function<void(entt::registry& registry, entt::entity entity)> init);
+
+	template<typename T>
+	void emplace(entt::entity entity, T component)
+	{
+		record([entity, component = std::move(component)](entt::registry& registry) mutable {
+			if (registry.valid(entity))
+				registry.emplace_or_replace<T>(entity, std::move(component));
+		});
+	}
+
+	template<typename T>
+	void remove(entt::entity entity)
+	{
+		record([entity](entt::registry& registry) {
+			if (registry.valid(entity))
+				registry.remove_if_exists<T>(entity);
+		});
+	}
+
+	// Applies the structural changes in the order they were recorded, then destroys the entities
+	// in one batch sorted by id. Changes to entities destroyed in the meantime are skipped.
+	void flush(entt::registry& registry);
+
+private:
+	void record(Command command);
+
+	std::mutex m_Mutex;
+	std::vector<Command> m_Commands;
+	std::vector<entt::entity> m_Destroyed;
+
+	// Swapped with the recorded lists while flushing, so that commands can record new ones
+	std::vector<Command> m_Flushing;
+	std::vector<entt::entity> m_FlushingDestroyed;
+};
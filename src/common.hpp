@@ -1,9 +1,12 @@
 #pragma once
 
 // stlib
+#include <cmath>
+#include <array>
 #include <string>
 #include <tuple>
 #include <vector>
+#include <memory_resource>
 #include <stdexcept>
 
 // glfw (OpenGL)
@@ -17,6 +20,7 @@
 #include <glm/vec3.hpp>             // vec3
 #include <glm/mat3x3.hpp>           // mat3
 
+#include "entt.hpp"
 #include "ai/behavioral_tree.hpp"
 
 using namespace glm;
@@ -24,6 +28,9 @@ using namespace glm;
 // Size of all entities
 static const unsigned int SPRITE_SCALE = 100;
 
+// Width and height in tiles of the chunks that static tiles are batched into for drawing
+static const int TILE_CHUNK_SIZE = 16;
+
 // Note, here the window will show a width x height part of the game world, measured in px.
 // You could also define a window to show 1.5 x 1 part of your game world, where the aspect ratio depends on your window size.
 const ivec2 WINDOW_SIZE_IN_PX		 = { 1200, 800 };
@@ -38,9 +45,18 @@ const float END_TURN_COUNTDOWN = 1000.f; // Duration to wait for player movement
 const float END_TURN_VELOCITY_X = 20.f;  // Velocity in x-direction above which to reset end turn countdown
 const float END_TURN_VELOCITY_Y = 200.f; // Velocity in y-direction above which to reset end turn countdown
 const float AI_TURN_COUNTDOWN = 3 * END_TURN_COUNTDOWN; // Duration to wait for AI movement to end turn
+const float AI_TURN_MIN_COUNTDOWN = END_TURN_COUNTDOWN; // Once this has passed an AI turn ends as soon as every enemy is idle
+const float SIMULATION_STEP = 1000.f / 60.f; // The game is simulated in fixed steps so turbo mode plays out the same
+const int MAX_STEPS_PER_FRAME = 2; // Steps to catch up on after a slow frame, the rest is dropped
+const int TURBO_STEPS_PER_FRAME = 8; // Steps per rendered frame while fast forwarding
 const float AI_ACTION_COUNTDOWN = 500.f; // Duration to wait for AI process
 const float AI_SPEED = 70.f; // Default speed of AI entities
+const float AI_PATROL_STEP = 1000.f / 60.f; // Duration of a patrol step, patrols used to count frames
+const float AI_NEAR_DISTANCE = 800.f; // Enemies this close to a bro tick every frame, as do enemies on screen
+const float AI_FAR_TICK_INTERVAL = 250.f; // Duration between ticks of the remaining enemies
+const size_t AI_MAX_TICKS_PER_FRAME = 64; // Enemies past this many wait for the next frame
 const float PROJECTED_PATH_FADE_COUNTDOWN = 2000.f; // fading cycle of the projected path
+const size_t TURN_JOURNAL_CAPACITY = 16; // Number of turn starts kept around for rewinding
 // Camera constants
 const vec3 MENU_CAMERA_POSITION = glm::vec3(WINDOW_SIZE_IN_PX / 2, 690);
 const float GAME_CAMERA_PERSPECTIVE_FAR_BOUND = 4000.0f;
@@ -51,6 +67,7 @@ const float MIN_CAMERA_Z_POSITION = -900.0f;
 // Particle system constants
 const unsigned int MAX_NUM_PARTICLES = 4000;
 const float DEFAULT_PARTICLE_LIFETIME_MS = 10000.0f;
+const float GRASS_PARTICLE_INTERVAL_MS = 100.0f; // Time between two bursts of grass particles while a bro moves through grass
 const int NUM_BEES_PER_SWARM = 140;
 
 // Spritesheet constants
@@ -62,6 +79,10 @@ const uint SPRITESHEET_PIXEL_HEIGHT = 1024;
 // Physics constants
 const float HORIZONTAL_FRICTION_MAGNITUDE = 0.6;
 const float VELOCITY_BOUNCE_MULTIPLIER = -0.7;
+const float SLEEP_VELOCITY = 25.f;		// Speed in each direction under which a body is considered at rest
+const int SLEEP_TICKS = 30;				// Physics steps a body has to stay at rest before it is put to sleep
+const int SLEEP_CONTACT_TICKS = 3;		// A body is only at rest if it touched something within this many steps
+const uint32_t CONTACT_END_STEPS = 4;	// Steps two entities have to stay apart before their contact ends
 const float PI = 3.14159265359;
 
  // Game balancing constants
@@ -76,10 +97,13 @@ const int POINTS_LOST_BASIC_PROJECTILE = 1;
 const int POINTS_LOST_HELGE_PROJECTILE = 10;
 const float BASIC_PROJECTILE_MASS = 0.02f;
 const float HELGE_PROJECTILE_MASS = 5.0f;
+const float MAX_VELOCITY = 1250.f; // Fastest a bro can be launched or knocked back
 const float MAX_PROJECTILE_KNOCKBACK_VELOCITY = 400.0f;
 const float PROJECTILE_AIM_RANDOMNESS_FACTOR = 60.0f;
 const float HELGE_PROJECTILE_LIFETIME_MS = 150000.0f;
 const float BASIC_PROJECTILE_LIFETIME_MS = 60000.0f;
+const size_t MAX_PROJECTILES_PER_LEVEL = 64; // Enemies hold fire while this many projectiles are in flight
+const float PROJECTILE_REST_VELOCITY = 1.0f; // Projectiles slower than this are culled
 
 const float RAIN_HORIZONTAL_FRICTION_MAGNITUDE = 0.3;
 
@@ -101,6 +125,7 @@ inline std::string config_path(const std::string& name) { return data_path() + "
 // Append extension to the end of the given file name
 inline std::string yaml_file(const std::string& name) { return name + ".yaml"; };
 inline std::string png_file(const std::string& name) { return name + ".png"; };
+inline std::string save_file(const std::string& name) { return name + ".sav"; };
 
 struct Util {
 	static bool file_exists(const std::string& file_path);
@@ -124,13 +149,34 @@ struct Motion {
 	bool can_move = true;
 };
 
-// AI component that stores the behavior tree for an entity
+// AI component that references the behavior tree shared by every enemy of the same kind
 struct AI {
-	BehaviorTree::Node* behavior_tree = nullptr;
+	const BehaviorTree::Tree* behavior_tree = nullptr;
 	float countdown = AI_ACTION_COUNTDOWN;
 	std::optional<vec2> target = std::nullopt;
 };
 
+// Per-entity state of the AI's behavior tree
+struct Blackboard {
+	// The path is allocated from the scene's entity pool
+	explicit Blackboard(std::pmr::memory_resource* pool = std::pmr::get_default_resource()) : path(pool) {}
+
+	// Current child of each composite node in the tree
+	std::array<uint8_t, BehaviorTree::MAX_TREE_NODES> childIndex = {};
+	float patrolTime = 0.f;
+	// Time since the tree was last ticked, handed to it on its next tick
+	float pendingTime = 0.f;
+	// Whether the tree had nothing in progress on its last tick
+	bool idle = false;
+	// Nearest bro, sensed once per tick
+	vec3 nearestBro = vec3(0.f);
+	float nearestBroDistance = INFINITY;
+	// Shortest path to the goal, found once by MoveToGoal
+	std::pmr::vector<vec2> path;
+	uint16_t pathIndex = 0;
+	bool goalReached = false;
+};
+
 struct SlingMotion {
 	bool canClick = true;
 	bool isClicked = false;
@@ -157,6 +203,13 @@ struct Hazard
 	vec3 position = vec3(0, 0, 0);
 };
 
+// Indicates that an entity is moved by its AI rather than by forces. Kinematic bodies follow their
+// velocity (or their AI's target) in a pass of their own and never get gravity or friction.
+struct Kinematic
+{
+	uint32_t placeholder = 0;
+};
+
 // Indicates that an entity is affected by gravity
 struct Gravity
 {
@@ -184,6 +237,51 @@ struct IgnorePhysics
 	uint16_t placeholder = 0;
 };
 
+// Rest state of a dynamic body. Bodies that stay at rest for SLEEP_TICKS physics steps are put to sleep
+// and skipped by the physics system until something touches them or changes their motion.
+struct Sleep
+{
+	bool asleep = false;
+	int restingTicks = 0;
+	int ticksSinceContact = 0;
+
+	// Position the body fell asleep at, moving it from elsewhere wakes it up
+	vec3 position = vec3(0, 0, 0);
+
+	void wake()
+	{
+		asleep = false;
+		restingTicks = 0;
+	}
+};
+
+// Layers that bodies collide on. Each layer only tests for collisions against the layers listed
+// for it in the interaction matrix of the physics system.
+enum CollisionLayer : uint16_t
+{
+	LAYER_NONE = 0,
+	LAYER_BRO = 1 << 0,
+	LAYER_ENEMY = 1 << 1,
+	LAYER_SNAIL = 1 << 2,
+	LAYER_PROJECTILE = 1 << 3,
+	LAYER_TILE = 1 << 4,
+	LAYER_TRIGGER = 1 << 5
+};
+
+// Collision layer of an entity, entities without one are never tested for collisions.
+// Triggers (power-ups, goals, spikes) are only overlap tested against the layers that activate them.
+struct Collider
+{
+	uint16_t layer = LAYER_NONE;
+	uint16_t activatedBy = LAYER_NONE;
+};
+
+// Surface material of a tile, an index into the MaterialTable
+struct Material
+{
+	uint8_t id = 0;
+};
+
 // Component that makes the entity be ignored by the level saver
 struct IgnoreSave
 {
@@ -236,6 +334,12 @@ enum BroType {
 struct PlayerProfile {
 	std::string playerName;
 	BroType broType;
+
+	// Bro the profile shows the points of, and the colour of its name during the bro's turn
+	entt::entity bro = entt::null;
+	vec3 highlightColour = { 0.f, 0.f, 0.f };
+	// Points the profile's text currently shows
+	int shownPoints = -1;
 };
 
 struct CollidableEnemy
@@ -17,8 +17,7 @@ namespace DebugSystem
 	{
 		auto entity = WorldSystem::ActiveScene->CreateEntity("Debug");
 
-		std::string key = "thick_line";
-		ShadedMesh& resource = cache_resource(key);
+		ShadedMesh& resource = cache_resource("thick_line"_hs);
 
 		if (resource.effect.program.resource == 0) {
 
@@ -81,8 +80,7 @@ namespace DebugSystem
 
 	void createCircle(vec3 position, vec3 scale) {
 		auto entity = WorldSystem::ActiveScene->CreateEntity("Debug Circle");
-		std::string key = "debug_circle";
-		ShadedMesh& resource = cache_resource(key);
+		ShadedMesh& resource = cache_resource("debug_circle"_hs);
 
 		if (resource.effect.program.resource == 0) {
 			RenderSystem::createSprite(resource, textures_path("debug_circle.png"), "textured");
@@ -101,10 +99,7 @@ namespace DebugSystem
 	void clearDebugComponents()
 	{
 		auto debugEntitiesView = WorldSystem::ActiveScene->m_Registry.view<DebugComponent>();
-
-		for (auto debugEntity : debugEntitiesView) {
-			WorldSystem::ActiveScene->m_Registry.destroy(debugEntity);
-		}
+		WorldSystem::ActiveScene->m_Registry.destroy(debugEntitiesView.begin(), debugEntitiesView.end());
 	}
 
 	bool in_debug_mode = false;
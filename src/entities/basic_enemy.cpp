@@ -3,16 +3,13 @@
 #include "animation.hpp"
 
 #include <ai/behavioral_tree.hpp>
-#include <ai/attack.hpp>
-#include <ai/movement.hpp>
 
 ECS_ENTT::Entity BasicEnemy::createBasicEnemy(vec3 position, ECS_ENTT::Scene* scene)
 {
 
 	ECS_ENTT::Entity basicEnemyEntity = scene->CreateEntity("Basic Enemy");
 
-	std::string key = "enemy_basic";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_basic"_hs);
 
 	if (resource.effect.program.resource == 0)
 		RenderSystem::createSprite(resource, textures_path("enemy_characters_spritesheet.png"), "textured", { 0, 0 });
@@ -28,18 +25,22 @@ ECS_ENTT::Entity BasicEnemy::createBasicEnemy(vec3 position, ECS_ENTT::Scene* sc
 	motionComponent.scale = {resource.mesh.original_size.x * SPRITE_SCALE, resource.mesh.original_size.y * SPRITE_SCALE, 1.0f};
 	motionComponent.can_move = false;
 
-	// Initiate AI component + Behavior Tree for Basic Enemy
+	// Initiate AI component + Behavior Tree shared by every Basic Enemy
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Composite(BehaviorTree::NodeType::Selector, {
+		{ BehaviorTree::NodeType::ShootInRange, BASIC_ENEMY_MAX_SHOOT_RANGE },
+		{ BehaviorTree::NodeType::Patrol, BASIC_ENEMY_STEPS_BEFORE_TURN }
+	});
 	AI& aiComponent = basicEnemyEntity.AddComponent<AI>();
-	auto* shootNode = new ShootInRange(BASIC_ENEMY_MAX_SHOOT_RANGE);
-	auto* patrolNode = new Patrol(BASIC_ENEMY_STEPS_BEFORE_TURN);
-	auto* root = new BehaviorTree::Selector(std::vector<BehaviorTree::Node*>({shootNode, patrolNode}));
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	basicEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	basicEnemyEntity.AddComponent<BasicEnemy>();
 	basicEnemyEntity.AddComponent<CollidableEnemy>();
+	basicEnemyEntity.AddComponent<Collider>(LAYER_ENEMY);
+	basicEnemyEntity.AddComponent<Kinematic>();
 
 	// Set up the animation component
-	basicEnemyEntity.AddComponent<Animation>(key, glm::vec2(0, 0), 7, 200.0f, true);
+	basicEnemyEntity.AddComponent<Animation>(resource.handle, glm::vec2(0, 0), 7, 200.0f, true);
 
 	return basicEnemyEntity;
 }
\ No newline at end of file
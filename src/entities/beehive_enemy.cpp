@@ -5,8 +5,7 @@ ECS_ENTT::Entity BeeHiveEnemy::createBeeHiveEnemy(vec3 position, ECS_ENTT::Scene
 
 	ECS_ENTT::Entity beehiveEntity = scene->CreateEntity("Bee Hive Enemy");
 
-	std::string key = "enemy_beehive";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_beehive"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_beehive.png"), "textured");
@@ -24,11 +23,11 @@ ECS_ENTT::Entity BeeHiveEnemy::createBeeHiveEnemy(vec3 position, ECS_ENTT::Scene
 	motionComponent.can_move = false;
 
 	BeeHiveEnemy& beeHiveComponent = beehiveEntity.AddComponent<BeeHiveEnemy>();
+	beehiveEntity.AddComponent<Collider>(LAYER_ENEMY);
 
 	// Create a swarm of bees around the hive
 	ParticleSystem* particleSystem = ParticleSystem::GetInstance();
-	beeHiveComponent.hiveSwarm = particleSystem->CreateBeeSwarm(position, NUM_BEES_PER_SWARM);
-	beeHiveComponent.hiveSwarm->scene = scene;
+	beeHiveComponent.hiveSwarm = particleSystem->CreateBeeSwarm(position, NUM_BEES_PER_SWARM, scene);
 
 	return beehiveEntity;
 }
@@ -2,14 +2,12 @@
 #include "render.hpp"
 
 #include <ai/behavioral_tree.hpp>
-#include <ai/movement.hpp>
 
 ECS_ENTT::Entity BirdEnemy::createBirdEnemy(vec3 position, ECS_ENTT::Scene* scene) {
 
 	ECS_ENTT::Entity birdEnemyEntity = scene->CreateEntity("Bird Enemy");
 
-	std::string key = "enemy_bird";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_bird"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_bird.png"), "textured");
@@ -27,13 +25,17 @@ ECS_ENTT::Entity BirdEnemy::createBirdEnemy(vec3 position, ECS_ENTT::Scene* scen
 	motionComponent.can_move = false;
 
 	// InitiateAI components
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Composite(BehaviorTree::NodeType::Selector, {
+		{ BehaviorTree::NodeType::SkyPatrol, BIRD_ENEMY_STEPS_BEFORE_TURN }
+	});
 	AI& aiComponent = birdEnemyEntity.AddComponent<AI>();
-	auto* skyPatrolNode = new SkyPatrol(BIRD_ENEMY_STEPS_BEFORE_TURN);
-	auto* root = new BehaviorTree::Selector(std::vector<BehaviorTree::Node*>({ skyPatrolNode }));
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	birdEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	birdEnemyEntity.AddComponent<BirdEnemy>();
 	birdEnemyEntity.AddComponent<CollidableEnemy>();
+	birdEnemyEntity.AddComponent<Collider>(LAYER_ENEMY);
+	birdEnemyEntity.AddComponent<Kinematic>();
 
 	return birdEnemyEntity;
 }
\ No newline at end of file
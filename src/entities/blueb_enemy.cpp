@@ -2,14 +2,12 @@
 #include "render.hpp"
 
 #include <ai/behavioral_tree.hpp>
-#include <ai/movement.hpp>
 
 ECS_ENTT::Entity BluebEnemy::createBluebEnemy(vec3 position, ECS_ENTT::Scene* scene) {
 
 	ECS_ENTT::Entity bluebEnemyEntity = scene->CreateEntity("Blueb Enemy");
 
-	std::string key = "enemy_blueb";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_blueb"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_blueb.png"), "textured");
@@ -27,13 +25,17 @@ ECS_ENTT::Entity BluebEnemy::createBluebEnemy(vec3 position, ECS_ENTT::Scene* sc
 	motionComponent.can_move = false;
 
 	// InitiateAI components
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Composite(BehaviorTree::NodeType::Selector, {
+		{ BehaviorTree::NodeType::Patrol, BLUEB_ENEMY_STEPS_BEFORE_TURN }
+	});
 	AI& aiComponent = bluebEnemyEntity.AddComponent<AI>();
-	auto* patrolNode = new Patrol(BLUEB_ENEMY_STEPS_BEFORE_TURN);
-	auto* root = new BehaviorTree::Selector(std::vector<BehaviorTree::Node*>({ patrolNode }));
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	bluebEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	bluebEnemyEntity.AddComponent<BluebEnemy>();
 	bluebEnemyEntity.AddComponent<CollidableEnemy>();
+	bluebEnemyEntity.AddComponent<Collider>(LAYER_ENEMY);
+	bluebEnemyEntity.AddComponent<Kinematic>();
 
 	return bluebEnemyEntity;
 }
\ No newline at end of file
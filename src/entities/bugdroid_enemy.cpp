@@ -2,14 +2,12 @@
 #include "render.hpp"
 
 #include <ai/behavioral_tree.hpp>
-#include <ai/attack.hpp>
 
 ECS_ENTT::Entity BugDroidEnemy::createBugDroidEnemy(vec3 position, ECS_ENTT::Scene* scene) {
 
 	ECS_ENTT::Entity bugDroidEnemyEntity = scene->CreateEntity("BugDroid Enemy");
 
-	std::string key = "enemy_bugdroid";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_bugdroid"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_bugdroid.png"), "textured");
@@ -26,13 +24,17 @@ ECS_ENTT::Entity BugDroidEnemy::createBugDroidEnemy(vec3 position, ECS_ENTT::Sce
 	motionComponent.scale = { resource.mesh.original_size.x * SPRITE_SCALE, resource.mesh.original_size.y * SPRITE_SCALE, 1.0f };
 
 	// InitiateAI components
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Composite(BehaviorTree::NodeType::Selector, {
+		{ BehaviorTree::NodeType::ShootInRange, BUGDROID_ENEMY_MAX_SHOOT_RANGE }
+	});
 	AI& aiComponent = bugDroidEnemyEntity.AddComponent<AI>();
-	auto* shootNode = new ShootInRange(BUGDROID_ENEMY_MAX_SHOOT_RANGE);
-	auto* root = new BehaviorTree::Selector(std::vector<BehaviorTree::Node*>({ shootNode }));
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	bugDroidEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	bugDroidEnemyEntity.AddComponent<BugDroidEnemy>();
 	bugDroidEnemyEntity.AddComponent<CollidableEnemy>();
+	bugDroidEnemyEntity.AddComponent<Collider>(LAYER_ENEMY);
+	bugDroidEnemyEntity.AddComponent<Kinematic>();
 
 	return bugDroidEnemyEntity;
 }
\ No newline at end of file
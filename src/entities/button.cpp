@@ -6,7 +6,7 @@ ECS_ENTT::Entity Button::createButton(vec2 position, vec2 scale, const std::stri
 {
 	std::string buttonName = "button_" + functionName;
 
-	ShadedMesh& meshResource = cache_resource(buttonName);
+	ShadedMesh& meshResource = cache_resource(resource_key(buttonName));
 	if (meshResource.effect.program.resource == 0) {
 		RenderSystem::createSprite(meshResource, textures_path(png_file(buttonName)), "textured");
 	}
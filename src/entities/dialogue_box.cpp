@@ -7,7 +7,8 @@ ECS_ENTT::Entity DialogueBox::createDialogueBox(std::string fileName, ECS_ENTT::
 	
 	scene->current_dialogue_box = fileName;
 	
-	ShadedMesh& meshResource = cache_resource(fileName);
+	// Story images are only shown once, so they are unloaded as soon as the box is dismissed
+	ShadedMesh& meshResource = cache_resource(resource_key(fileName), ResourceLifetime::Level);
 	if (meshResource.effect.program.resource == 0) {
 		RenderSystem::createDialogueSprite(meshResource, story_textures_path(fileName), "dialogue_box");
 	}
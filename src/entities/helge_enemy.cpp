@@ -3,15 +3,12 @@
 #include "animation.hpp"
 
 #include <ai/behavioral_tree.hpp>
-#include <ai/attack.hpp>
-#include <ai/movement.hpp>
 
 ECS_ENTT::Entity HelgeEnemy::createHelgeEnemy(vec3 position, ECS_ENTT::Scene* scene) {
 
 	ECS_ENTT::Entity helgeEnemyEntity = scene->CreateEntity("Helge Enemy");
 
-	std::string key = "enemy_helge";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_helge"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_characters_spritesheet.png"), "textured", { 0, 2 });
@@ -28,15 +25,20 @@ ECS_ENTT::Entity HelgeEnemy::createHelgeEnemy(vec3 position, ECS_ENTT::Scene* sc
 	motionComponent.scale = { resource.mesh.original_size.x * SPRITE_SCALE * 2.5f, resource.mesh.original_size.y * SPRITE_SCALE * 2.5f, 1.0f };
 	motionComponent.can_move = false;
 
+	// Built once and shared by every enemy of this kind
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Composite(BehaviorTree::NodeType::Selector, {
+		{ BehaviorTree::NodeType::HelgeShootInRange, HELGE_ENEMY_MAX_SHOOT_RANGE },
+		{ BehaviorTree::NodeType::Patrol, HELGE_ENEMY_STEPS_BEFORE_TURN }
+	});
 	AI& aiComponent = helgeEnemyEntity.AddComponent<AI>();
-	auto* shootNode = new HelgeShootInRange(HELGE_ENEMY_MAX_SHOOT_RANGE);
-	auto* patrolNode = new Patrol(HELGE_ENEMY_STEPS_BEFORE_TURN);
-	auto* root = new BehaviorTree::Selector(std::vector<BehaviorTree::Node*>({ shootNode, patrolNode }));
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	helgeEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	helgeEnemyEntity.AddComponent<HelgeEnemy>();
+	helgeEnemyEntity.AddComponent<Collider>(LAYER_ENEMY);
+	helgeEnemyEntity.AddComponent<Kinematic>();
 
-	helgeEnemyEntity.AddComponent<Animation>(key, glm::vec2(0, 2), 7, 200.0f, true);
+	helgeEnemyEntity.AddComponent<Animation>(resource.handle, glm::vec2(0, 2), 7, 200.0f, true);
 
 	return helgeEnemyEntity;
 }
\ No newline at end of file
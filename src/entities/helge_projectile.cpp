@@ -5,8 +5,7 @@
 ECS_ENTT::Entity HelgeProjectile::createHelgeProjectile(vec3 position, ECS_ENTT::Scene* scene) {
 	ECS_ENTT::Entity helgeProjectileEntity = scene->CreateEntity("Helge Projectile");
 
-	std::string key = "projectile_helge";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("projectile_helge"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("projectile_f_minus.png"), "textured");
@@ -22,7 +21,9 @@ ECS_ENTT::Entity HelgeProjectile::createHelgeProjectile(vec3 position, ECS_ENTT:
 	motionComponent.velocity = { 0.0f, 0.0f, 0.0f };
 	motionComponent.scale = { resource.mesh.original_size.x * 50.f, resource.mesh.original_size.y * 50.f, 1.0f };
 
-	helgeProjectileEntity.AddComponent<HelgeProjectile>();
+	auto& helgeProjectile = helgeProjectileEntity.AddComponent<HelgeProjectile>();
+	helgeProjectile.lifetime = scene->m_Timers.schedule(TimerKind::ProjectileLifetime, helgeProjectileEntity, HELGE_PROJECTILE_LIFETIME_MS);
+	helgeProjectileEntity.AddComponent<Collider>(LAYER_PROJECTILE);
 
 	return helgeProjectileEntity;
 }
\ No newline at end of file
@@ -8,5 +8,6 @@ struct HelgeProjectile
 {
 	static ECS_ENTT::Entity createHelgeProjectile(vec3 position, ECS_ENTT::Scene* scene);
 
-	float timeRemaining = HELGE_PROJECTILE_LIFETIME_MS;
+	// Timer returning the projectile to the pool at the end of its lifetime
+	TimerId lifetime = 0;
 };
\ No newline at end of file
@@ -3,8 +3,6 @@
 
 const glm::vec3 BACKGROUND_POSITION = glm::vec3(500.0f, 0.0f, -1000.0f);
 
-uint32_t ParallaxBackground::backgroundID = 0;
-
 ECS_ENTT::Entity ParallaxBackground::createBackground(ECS_ENTT::Scene* scene, std::string backgroundFilename) {
 
 	if (backgroundFilename == "")
@@ -12,9 +10,8 @@ ECS_ENTT::Entity ParallaxBackground::createBackground(ECS_ENTT::Scene* scene, st
 
 	ECS_ENTT::Entity backgroundEntity = scene->CreateEntity("Background");
 
-	std::string key = "background_";
-	key += std::to_string(backgroundID++);
-	ShadedMesh& resource = cache_resource(key);
+	// Backgrounds are keyed by file so levels sharing one share the texture, and unloaded with the last level using them
+	ShadedMesh& resource = cache_resource(resource_key("background_" + backgroundFilename), ResourceLifetime::Level);
 
 	if (resource.effect.program.resource == 0) 
 		RenderSystem::createBackgroundSprite(resource, textures_path(backgroundFilename), "textured");
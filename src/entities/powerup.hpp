@@ -1,6 +1,6 @@
 #include "Entity.h"
 
 struct PowerUp {
-	// Bug fix for now, just adding something here so that this component isn't empty since apparently EnTT doesn't like empty components
-	uint32_t placeholder = 0;
+	// Set once a bro picked the power-up up, it is only destroyed at the end of the step
+	bool consumed = false;
 };
\ No newline at end of file
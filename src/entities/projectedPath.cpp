@@ -3,7 +3,7 @@
 
 ECS_ENTT::Entity ProjectedPath::createProjectedPoint(vec3 position, float scale, ECS_ENTT::Scene* scene)
 {
-	ShadedMesh& meshResource = cache_resource("starPath");
+	ShadedMesh& meshResource = cache_resource("starPath"_hs);
 	if (meshResource.effect.program.resource == 0) {
 		RenderSystem::createSprite(meshResource, textures_path("starPath.png"), "textured");
 	}
@@ -6,8 +6,7 @@ ECS_ENTT::Entity Projectile::createProjectile(vec3 position, ECS_ENTT::Scene *sc
 {
 	ECS_ENTT::Entity projectileEntity = scene->CreateEntity("Projectile");
 
-	std::string key = "projectile";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("projectile"_hs);
 	if (resource.mesh.vertices.empty())
 	{
 		resource.mesh.loadFromOBJFile(mesh_path("circle.obj"));
@@ -28,7 +27,9 @@ ECS_ENTT::Entity Projectile::createProjectile(vec3 position, ECS_ENTT::Scene *sc
 	motionComponent.scale = { resource.mesh.original_size.x * 20.f, resource.mesh.original_size.y * 20.f, 1.0f };
 
 	// Create an (empty) projectile component to be able to refer to all projectiles
-	projectileEntity.AddComponent<Projectile>(); // TODO check if we can't add empty components, seems to cause a bug 
+	auto& projectile = projectileEntity.AddComponent<Projectile>();
+	projectile.lifetime = scene->m_Timers.schedule(TimerKind::ProjectileLifetime, projectileEntity, BASIC_PROJECTILE_LIFETIME_MS);
+	projectileEntity.AddComponent<Collider>(LAYER_PROJECTILE);
 
 	return projectileEntity;
 }
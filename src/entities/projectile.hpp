@@ -9,5 +9,6 @@ struct Projectile
 	// Creates all the associated render resources and default transform
 	static ECS_ENTT::Entity createProjectile(vec3 position, ECS_ENTT::Scene* scene);
 
-	float timeRemaining = BASIC_PROJECTILE_LIFETIME_MS;
+	// Timer returning the projectile to the pool at the end of its lifetime
+	TimerId lifetime = 0;
 };
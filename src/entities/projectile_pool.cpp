@@ -0,0 +1,100 @@
+#include "projectile_pool.hpp"
+#include "projectile.hpp"
+#include "helge_projectile.hpp"
+
+namespace
+{
+	template<typename T>
+	std::optional<ECS_ENTT::Entity> acquire(vec3 position, ECS_ENTT::Scene* scene, ECS_ENTT::Entity (*create)(vec3, ECS_ENTT::Scene*), float lifetime_ms)
+	{
+		if (ProjectilePool::numInFlight(scene) >= MAX_PROJECTILES_PER_LEVEL)
+			return std::nullopt;
+
+		auto& registry = scene->m_Registry;
+		auto pooled = registry.view<T, InactiveProjectile>();
+		if (pooled.begin() == pooled.end())
+			return (*create)(position, scene);
+
+		ECS_ENTT::Entity projectile = ECS_ENTT::Entity(*pooled.begin(), scene);
+		Motion motion = projectile.GetComponent<InactiveProjectile>().motion;
+		projectile.RemoveComponent<InactiveProjectile>();
+
+		motion.position = position;
+		motion.angle = 0.0f;
+		motion.velocity = { 0.0f, 0.0f, 0.0f };
+		projectile.AddComponent<Motion>(motion);
+		projectile.GetComponent<T>().lifetime = scene->m_Timers.schedule(TimerKind::ProjectileLifetime, projectile, lifetime_ms);
+		return projectile;
+	}
+
+	template<typename T>
+	void reserve(ECS_ENTT::Scene* scene, ECS_ENTT::Entity (*create)(vec3, ECS_ENTT::Scene*))
+	{
+		while (scene->m_Registry.size<T>() < MAX_PROJECTILES_PER_LEVEL)
+			ProjectilePool::release((*create)(vec3(0.f), scene));
+	}
+
+	template<typename T>
+	void step_projectiles(ECS_ENTT::Scene* scene)
+	{
+		auto& registry = scene->m_Registry;
+		auto view = registry.view<T, Motion>();
+		for (auto entityID : view)
+		{
+			auto& motion = view.template get<Motion>(entityID);
+
+			// The physics system keeps bodies inside the scene, so projectiles that reached its edge are culled
+			float radius = 0.5f * glm::length(vec2(motion.scale));
+			bool at_edge = motion.position.x - radius <= 1.f || motion.position.x + radius >= scene->m_Size.x - 1.f
+						   || motion.position.y - radius <= 1.f || motion.position.y + radius >= scene->m_Size.y - 1.f;
+			bool at_rest = glm::length(vec2(motion.velocity)) < PROJECTILE_REST_VELOCITY;
+
+			if (at_edge || at_rest)
+				ProjectilePool::release(ECS_ENTT::Entity(entityID, scene));
+		}
+	}
+}
+
+std::optional<ECS_ENTT::Entity> ProjectilePool::acquireProjectile(vec3 position, ECS_ENTT::Scene* scene)
+{
+	return acquire<Projectile>(position, scene, Projectile::createProjectile, BASIC_PROJECTILE_LIFETIME_MS);
+}
+
+std::optional<ECS_ENTT::Entity> ProjectilePool::acquireHelgeProjectile(vec3 position, ECS_ENTT::Scene* scene)
+{
+	return acquire<HelgeProjectile>(position, scene, HelgeProjectile::createHelgeProjectile, HELGE_PROJECTILE_LIFETIME_MS);
+}
+
+void ProjectilePool::release(ECS_ENTT::Entity projectile)
+{
+	Motion motion = projectile.GetComponent<Motion>();
+	projectile.RemoveComponent<Motion>();
+	projectile.AddComponent<InactiveProjectile>(motion);
+}
+
+void ProjectilePool::releaseAll(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	for (auto entityID : registry.view<Projectile>(entt::exclude<InactiveProjectile>))
+		release(ECS_ENTT::Entity(entityID, scene));
+	for (auto entityID : registry.view<HelgeProjectile>(entt::exclude<InactiveProjectile>))
+		release(ECS_ENTT::Entity(entityID, scene));
+}
+
+void ProjectilePool::step(ECS_ENTT::Scene* scene)
+{
+	step_projectiles<Projectile>(scene);
+	step_projectiles<HelgeProjectile>(scene);
+}
+
+size_t ProjectilePool::numInFlight(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	return registry.size<Projectile>() + registry.size<HelgeProjectile>() - registry.size<InactiveProjectile>();
+}
+
+void ProjectilePool::reserve(ECS_ENTT::Scene* scene)
+{
+	::reserve<Projectile>(scene, Projectile::createProjectile);
+	::reserve<HelgeProjectile>(scene, HelgeProjectile::createHelgeProjectile);
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "common.hpp"
+#include "Entity.h"
+#include "Scene.h"
+
+#include <optional>
+
+// Tag of a projectile waiting in the pool. It keeps its entity and mesh reference but not its
+// Motion, so physics, rendering and saving skip it until it is fired again.
+struct InactiveProjectile
+{
+	Motion motion; // Motion the projectile had when it was released, to restore its scale from
+};
+
+// Reuses the projectiles of a scene instead of creating an entity for every shot,
+// and caps how many projectiles can be in flight in a level at once
+struct ProjectilePool
+{
+	// Fires a pooled projectile from a position, or returns nothing if the level is at its projectile cap
+	static std::optional<ECS_ENTT::Entity> acquireProjectile(vec3 position, ECS_ENTT::Scene* scene);
+	static std::optional<ECS_ENTT::Entity> acquireHelgeProjectile(vec3 position, ECS_ENTT::Scene* scene);
+
+	// Returns a projectile in flight to the pool
+	static void release(ECS_ENTT::Entity projectile);
+
+	static void releaseAll(ECS_ENTT::Scene* scene);
+
+	// Releases the projectiles that left the scene or came to rest, the
+	// scene's timer queue releases those at the end of their lifetime
+	static void step(ECS_ENTT::Scene* scene);
+
+	static size_t numInFlight(ECS_ENTT::Scene* scene);
+
+	// Fills the pool so that acquiring never has to create a projectile, which needs the render thread
+	static void reserve(ECS_ENTT::Scene* scene);
+};
@@ -4,7 +4,7 @@
 
 ECS_ENTT::Entity GameScreen::createScreen(const std::string& texture_name, vec2 pos, ECS_ENTT::Scene* scene)
 {
-	ShadedMesh& meshResource = cache_resource(texture_name);
+	ShadedMesh& meshResource = cache_resource(resource_key(texture_name));
 	if (meshResource.effect.program.resource == 0) {
 		RenderSystem::createSprite(meshResource, textures_path(png_file(texture_name)), "textured");
 	}
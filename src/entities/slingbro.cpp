@@ -3,10 +3,16 @@
 #include "render.hpp"
 #include "animation.hpp"
 
-std::map<BroType, std::string> bro_keys =
+const std::map<BroType, ResourceKey> bro_keys =
 		{
-				{BroType::ORANGE, "slingbro_orange"},
-				{BroType::PINK, "slingbro_pink"}
+				{BroType::ORANGE, "slingbro_orange"_hs},
+				{BroType::PINK, "slingbro_pink"_hs}
+		};
+
+const std::map<BroType, ResourceKey> bro_profile_keys =
+		{
+				{BroType::ORANGE, "slingbro_orangeprofile"_hs},
+				{BroType::PINK, "slingbro_pinkprofile"_hs}
 		};
 
 ECS_ENTT::Entity SlingBro::createOrangeSlingBro(vec3 position, ECS_ENTT::Scene* scene)
@@ -31,15 +37,9 @@ ECS_ENTT::Entity SlingBro::createPinkSlingBroProfile(vec3 position, ECS_ENTT::Sc
 
 ECS_ENTT::Entity SlingBro::createSlingBro(vec3 position, ECS_ENTT::Scene *scene, BroType type, bool isProfile)
 {
-	std::string key = bro_keys.at(type);
-
-	if (isProfile)
-	{
-		key += "profile";
-	}
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource(isProfile ? bro_profile_keys.at(type) : bro_keys.at(type));
 
-	ECS_ENTT::Entity slingBroEntity = scene->CreateEntity(key);
+	ECS_ENTT::Entity slingBroEntity = scene->CreateEntity(isProfile ? "Sling Bro Profile" : "Sling Bro");
 
 	vec2 spritesheet_offset = vec2(0, type);
 
@@ -93,12 +93,14 @@ ECS_ENTT::Entity SlingBro::createSlingBro(vec3 position, ECS_ENTT::Scene *scene,
 			{
 				profile.broType = BroType::ORANGE;
 				profile.playerName = "Timmy";
+				profile.highlightColour = { 0.87f, 0.48f, 0.17f };
 				break;
 			}
 			case BroType::PINK:
 			{
 				profile.broType = BroType::PINK;
 				profile.playerName = "Tammy";
+				profile.highlightColour = { 1.f, 0.51f, 0.77f };
 			}
 		}
 
@@ -119,10 +121,12 @@ ECS_ENTT::Entity SlingBro::createSlingBro(vec3 position, ECS_ENTT::Scene *scene,
 		auto& turn = slingBroEntity.AddComponent<Turn>();
 
 		// Set up the animation component
-		slingBroEntity.AddComponent<Animation>(key, spritesheet_offset, 6, 200.0f, true);
+		slingBroEntity.AddComponent<Animation>(resource.handle, spritesheet_offset, 6, 200.0f, true);
 
 		// Add gravity
 		slingBroEntity.AddComponent<Gravity>();
+		slingBroEntity.AddComponent<Sleep>();
+		slingBroEntity.AddComponent<Collider>(LAYER_BRO);
 
 		// Add mass
 		slingBroEntity.AddComponent<Mass>();
@@ -142,3 +146,13 @@ ECS_ENTT::Entity SlingBro::createSlingBro(vec3 position, ECS_ENTT::Scene *scene,
 
 	return slingBroEntity;
 }
+
+void Deformation::start(ECS_ENTT::Scene* scene, entt::entity entity, float scaleX, float scaleY, float angleRadians, float deformationTimeMs)
+{
+	auto& deformation = scene->m_Registry.get_or_emplace<Deformation>(entity);
+	deformation.scaleX = scaleX;
+	deformation.scaleY = scaleY;
+	deformation.angleRadians = angleRadians;
+	deformation.active = true;
+	deformation.timer = scene->m_Timers.schedule(TimerKind::Deformation, entity, deformationTimeMs);
+}
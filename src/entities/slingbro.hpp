@@ -29,12 +29,15 @@ struct SlingBro {
 	uint32_t placeholder = 0;
 };
 
+// Squash and stretch of an entity after an impact. The component stays on the entity once it was
+// deformed, and its timer switches it off rather than removing it.
 struct Deformation {
-	Deformation(float scaleX, float scaleY, float angleRadians, float deformationTimeMs)
-		: scaleX(scaleX), scaleY(scaleY), angleRadians(angleRadians), timeRemaining(deformationTimeMs)
-	{}
-	float timeRemaining;
+	// Deforms an entity for a while, replacing any deformation still playing
+	static void start(ECS_ENTT::Scene* scene, entt::entity entity, float scaleX, float scaleY, float angleRadians, float deformationTimeMs);
+
 	float scaleX = 1.0f;
 	float scaleY = 1.0f;
 	float angleRadians = 0.0f;
+	bool active = false;
+	TimerId timer = 0;
 };
\ No newline at end of file
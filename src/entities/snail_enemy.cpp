@@ -1,14 +1,12 @@
 #include "snail_enemy.hpp"
 #include "render.hpp"
 #include "ai/behavioral_tree.hpp"
-#include "ai/pathfinding.hpp"
 
 ECS_ENTT::Entity SnailEnemy::createSnailEnemy(vec3 position, ECS_ENTT::Scene* scene) {
 
 	ECS_ENTT::Entity snailEnemyEntity = scene->CreateEntity("Snail Enemy");
 
-	std::string key = "enemy_snail";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("enemy_snail"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("enemy_snail.png"), "textured");
@@ -24,11 +22,15 @@ ECS_ENTT::Entity SnailEnemy::createSnailEnemy(vec3 position, ECS_ENTT::Scene* sc
 	motionComponent.velocity = { 0.0f, 0.0f, 0.0f };
 	motionComponent.scale = { resource.mesh.original_size.x * SPRITE_SCALE, resource.mesh.original_size.y * SPRITE_SCALE, 1.0f };
 
+	// Built once and shared by every snail
+	static const BehaviorTree::Tree behaviorTree = BehaviorTree::Tree::Leaf(BehaviorTree::NodeType::MoveToGoal);
 	AI& aiComponent = snailEnemyEntity.AddComponent<AI>();
-	auto* root = new MoveToGoal();
-	aiComponent.behavior_tree = root;
+	aiComponent.behavior_tree = &behaviorTree;
+	snailEnemyEntity.AddComponent<Blackboard>(scene->GetEntityPool());
 
 	snailEnemyEntity.AddComponent<SnailEnemy>();
+	snailEnemyEntity.AddComponent<Collider>(LAYER_SNAIL);
+	snailEnemyEntity.AddComponent<Kinematic>();
 	snailEnemyEntity.AddComponent<CollidableEnemy>();
 
 	return snailEnemyEntity;
@@ -3,8 +3,6 @@
 #include "Scene.h"
 
 struct SnowyTile {
-	static ECS_ENTT::Entity createSnowyTile(vec3 position, ECS_ENTT::Scene* scene);
-
 	// Bug fix for now, just adding something here so that this component isn't empty since apparently EnTT doesn't like empty components
 	uint32_t placeholder = 0;
 };
\ No newline at end of file
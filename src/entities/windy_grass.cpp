@@ -6,8 +6,7 @@ ECS_ENTT::Entity WindyGrass::createGrass(vec3 position, ECS_ENTT::Scene* scene)
 
 	ECS_ENTT::Entity windyGrassEntity = scene->CreateEntity("Windy Grass");
 
-	std::string key = "windygrass";
-	ShadedMesh& resource = cache_resource(key);
+	ShadedMesh& resource = cache_resource("windygrass"_hs);
 
 	if (resource.effect.program.resource == 0) {
 		RenderSystem::createSprite(resource, textures_path("tile_blocks_spritesheet.png"), "textured", { 0, 0 });
@@ -27,10 +26,11 @@ ECS_ENTT::Entity WindyGrass::createGrass(vec3 position, ECS_ENTT::Scene* scene)
 	motionComponent.scale = { resource.mesh.original_size.x * SPRITE_SCALE, resource.mesh.original_size.y * SPRITE_SCALE, 1.0f };
 
 	windyGrassEntity.AddComponent<WindyGrass>();
+	windyGrassEntity.AddComponent<Collider>(LAYER_TRIGGER, LAYER_BRO);
 	windyGrassEntity.AddComponent<IgnorePhysics>();
 
 	// Set up the animation component
-	windyGrassEntity.AddComponent<Animation>(key, glm::vec2(0, 0), 4, 420.0f, false);
+	windyGrassEntity.AddComponent<Animation>(resource.handle, glm::vec2(0, 0), 4, 420.0f, false);
 
 	return windyGrassEntity;
 }
@@ -0,0 +1,93 @@
+#include "game_instance.hpp"
+#include "gameplay_system.hpp"
+#include "timer_system.hpp"
+#include "particle_system.hpp"
+#include "entities/projectile_pool.hpp"
+#include "entities/beehive_enemy.hpp"
+
+#include <algorithm>
+#include <thread>
+
+GameInstance::GameInstance()
+{
+	GameplaySystem::attach(*this);
+}
+
+void GameInstance::step(float step_ms)
+{
+	// Same order as the main loop, which interleaves the world, particles and rendering
+	ai.step(*this, step_ms, WINDOW_SIZE_IN_GAME_UNITS);
+	TimerSystem::step(scene, step_ms);
+	ProjectilePool::step(scene);
+	physics.step(*this, step_ms, WINDOW_SIZE_IN_GAME_UNITS);
+	scene->m_Commands.flush(scene->m_Registry);
+}
+
+GameInstance& GameBatch::add(std::unique_ptr<ECS_ENTT::Scene> scene)
+{
+	ProjectilePool::reserve(scene.get());
+
+	// The main thread would step the swarms while the workers move the bros they chase
+	ParticleSystem::GetInstance()->clearBeeSwarms(scene.get());
+	for (auto [entityID, hive] : scene->m_Registry.view<BeeHiveEnemy>().each())
+		hive.hiveSwarm = nullptr;
+
+	auto game = std::make_unique<GameInstance>();
+	game->scene = scene.get();
+	game->random = Random::Stream();
+	m_Scenes.push_back(std::move(scene));
+	m_Games.push_back(std::move(game));
+	return *m_Games.back();
+}
+
+void GameBatch::step(int steps)
+{
+	// Games share nothing mutable, so each worker takes every n-th game
+	size_t num_workers = std::min<size_t>(m_Games.size(), std::max(1u, std::thread::hardware_concurrency()));
+	auto work = [this, steps, num_workers](size_t first) {
+		for (size_t i = first; i < m_Games.size(); i += num_workers)
+			for (int n = 0; n < steps; n++)
+				m_Games[i]->step(SIMULATION_STEP);
+	};
+
+	std::vector<std::thread> workers;
+	for (size_t first = 1; first < num_workers; first++)
+		workers.emplace_back(work, first);
+	work(0);
+	for (auto& worker : workers)
+		worker.join();
+
+	gather();
+}
+
+void GameBatch::gather()
+{
+	m_State.offsets.clear();
+	m_State.entities.clear();
+	m_State.positions.clear();
+	m_State.velocities.clear();
+	m_State.isAITurn.clear();
+	m_State.results.clear();
+
+	for (const auto& game : m_Games)
+	{
+		m_State.offsets.push_back(m_State.entities.size());
+		m_State.isAITurn.push_back(game->is_ai_turn);
+		m_State.results.push_back(game->result);
+
+		// Bros in turn order, then the enemies
+		auto& registry = game->scene->m_Registry;
+		for (auto entityID : game->scene->GetRoster())
+			m_State.entities.push_back(entityID);
+		for (auto entityID : registry.view<AI, Motion>())
+			m_State.entities.push_back(entityID);
+
+		for (size_t i = m_State.offsets.back(); i < m_State.entities.size(); i++)
+		{
+			const Motion& motion = registry.get<Motion>(m_State.entities[i]);
+			m_State.positions.push_back(motion.position);
+			m_State.velocities.push_back(motion.velocity);
+		}
+	}
+	m_State.offsets.push_back(m_State.entities.size());
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include "common.hpp"
+#include "ai.hpp"
+#include "physics.hpp"
+#include "random.hpp"
+#include "Scene.h"
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+class ParticleSystem;
+
+// What happened in a game that its host may want to present, e.g. with sounds or by loading the next level
+enum GameEvent : uint8_t
+{
+	GAME_EVENT_BRO_HURT,			// A bro was hit by an enemy, a projectile or a spike
+	GAME_EVENT_BROS_BUMPED,			// Two bros ran into each other
+	GAME_EVENT_POWER_UP_TAKEN,		// A bro took the power-up, which is destroyed at the end of the step
+	GAME_EVENT_GOAL_REACHED,		// A bro reached the goal and won the level
+	GAME_EVENT_SNAIL_REACHED_GOAL,	// A snail reached the goal before the bros, the level is lost
+	GAME_EVENT_CONTACT,				// Any other contact, e.g. a bro landing on a tile
+};
+
+enum GameResult : uint8_t
+{
+	GAME_RESULT_NONE,
+	GAME_RESULT_WON,
+	GAME_RESULT_LOST,
+};
+
+// Everything one running game simulates. The systems read the scene, turn and random numbers
+// from here rather than from globals, so independent games can be stepped side by side.
+struct GameInstance
+{
+	ECS_ENTT::Scene* scene = nullptr;
+	bool is_ai_turn = true;
+	GameResult result = GAME_RESULT_NONE;
+
+	// This game's own stream, split from the session's master seed
+	RandomStream random;
+
+	AISystem ai;
+	PhysicsSystem physics;
+
+	// Where the rules emit their effects, none if the game isn't shown
+	ParticleSystem* particles = nullptr;
+
+	// Called by the rules for every GameEvent, none if the game isn't shown
+	std::function<void(GameEvent event, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall)> events;
+
+	// Attaches the GameplaySystem rules to the physics, so the listeners capture this game
+	GameInstance();
+	GameInstance(const GameInstance&) = delete;
+	GameInstance& operator=(const GameInstance&) = delete;
+
+	void report(GameEvent event, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall = false)
+	{
+		if (events)
+			events(event, entity_i, entity_j, hit_wall);
+	}
+
+	// Steps the simulation without rendering, audio or input, i.e. AI, projectiles and physics
+	void step(float step_ms);
+};
+
+// State of the entities that move in every game of a batch, laid out contiguously.
+// Game i owns the range [offsets[i], offsets[i + 1]) of the other arrays.
+struct GameBatchState
+{
+	std::vector<size_t> offsets;
+	std::vector<entt::entity> entities;
+	std::vector<vec3> positions;
+	std::vector<vec3> velocities;
+	std::vector<uint8_t> isAITurn;
+	std::vector<uint8_t> results;
+};
+
+// Steps many games in lockstep on worker threads, e.g. to validate replays in bulk or train the AI.
+// Batched games play by the same GameplaySystem rules as the shown game but present nothing: they
+// have no particles or events, so reaching the goal only sets their result. The ParticleSystem is
+// shared by every scene and stepped on the main thread, so batched games get no bee swarms either.
+class GameBatch
+{
+public:
+	/**
+	 * Adds a game for a scene that was loaded on the main thread. Loading creates meshes, so it can't
+	 * happen on the workers, and the scene's projectile pool is filled up front for the same reason.
+	 * The scene's bee swarms are removed from the shared ParticleSystem.
+	 *
+	 * @param scene The loaded level, owned by the batch from now on
+	 * @return The game, to attach collision listeners to or to set whose turn it is
+	 */
+	GameInstance& add(std::unique_ptr<ECS_ENTT::Scene> scene);
+
+	size_t size() const { return m_Games.size(); }
+
+	GameInstance& operator[](size_t i) { return *m_Games[i]; }
+
+	/**
+	 * Steps every game the same number of fixed steps, spreading the games over the hardware threads
+	 *
+	 * @param steps Number of SIMULATION_STEP steps to take
+	 */
+	void step(int steps = 1);
+
+	// State of every game after the last step
+	const GameBatchState& state() const { return m_State; }
+
+private:
+	void gather();
+
+	std::vector<std::unique_ptr<ECS_ENTT::Scene>> m_Scenes;
+	std::vector<std::unique_ptr<GameInstance>> m_Games;
+	GameBatchState m_State;
+};
@@ -0,0 +1,357 @@
+#include "gameplay_system.hpp"
+#include "game_instance.hpp"
+#include "particle_system.hpp"
+#include "entities/slingbro.hpp"
+#include "entities/powerup.hpp"
+#include "entities/speed_powerup.hpp"
+#include "entities/size_up_powerup.hpp"
+#include "entities/size_down_powerup.hpp"
+#include "entities/mass_up_powerup.hpp"
+#include "entities/coin_powerup.hpp"
+#include "entities/projectile.hpp"
+#include "entities/helge_projectile.hpp"
+#include "entities/projectile_pool.hpp"
+#include "entities/spike_hazard.hpp"
+#include "entities/hazard_tile_spike.hpp"
+#include "entities/goal_tile.hpp"
+#include "entities/snail_enemy.hpp"
+#include "entities/beehive_enemy.hpp"
+
+void GameplaySystem::attach(GameInstance& game)
+{
+	// Damage, power-ups and the goal only happen once per impact rather than every step of a contact
+	game.physics.attach([&game](ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
+		collision_listener(game, entity_i, entity_j, hit_wall);
+	}, CONTACT_BEGIN);
+}
+
+void GameplaySystem::collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall)
+{
+	if (!hit_wall && entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<Projectile>()) {
+		projectile_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HelgeProjectile>()) {
+		helge_projectile_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HazardSpike>()) {
+		ground_spike_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HazardTileSpike>()) {
+		tile_spike_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<CollidableEnemy>()) {
+		collidable_enemy_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<SlingBro>()) {
+		game.report(GAME_EVENT_BROS_BUMPED, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<PowerUp>()) {
+		powerup_collision_listener(game, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<GoalTile>())
+	{
+		game.result = GAME_RESULT_WON;
+		game.report(GAME_EVENT_GOAL_REACHED, entity_i, entity_j);
+	}
+	else if (entity_i.HasComponent<SnailEnemy>() && entity_j.HasComponent<GoalTile>())
+	{
+		game.result = GAME_RESULT_LOST;
+		game.report(GAME_EVENT_SNAIL_REACHED_GOAL, entity_i, entity_j);
+	}
+	else
+	{
+		game.report(GAME_EVENT_CONTACT, entity_i, entity_j, hit_wall);
+	}
+
+	// Hitting a hive is also an enemy collision, the honey comes on top of it
+	if (entity_i.IsValid() && entity_j.IsValid() && entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<BeeHiveEnemy>())
+		beehive_collision_listener(game, entity_i, entity_j);
+}
+
+void GameplaySystem::powerup_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j) {
+	// Two bros can reach the same power-up in one step
+	auto& powerUp = entity_j.GetComponent<PowerUp>();
+	if (powerUp.consumed)
+		return;
+	powerUp.consumed = true;
+
+	if (entity_j.HasComponent<SpeedPowerUp>()) {
+		SpeedPowerUp& speed_power_up = entity_j.GetComponent<SpeedPowerUp>();
+		speed_power_up.applyPowerUp(entity_i);
+	} else if (entity_j.HasComponent<SizeUpPowerUp>()) {
+		SizeUpPowerUp& size_up_power_up = entity_j.GetComponent<SizeUpPowerUp>();
+		size_up_power_up.applyPowerUp(entity_i);
+	} else if (entity_j.HasComponent<SizeDownPowerUp>()) {
+		SizeDownPowerUp& size_down_power_up = entity_j.GetComponent<SizeDownPowerUp>();
+		size_down_power_up.applyPowerUp(entity_i);
+	} else if (entity_j.HasComponent<CoinPowerUp>()) {
+		CoinPowerUp& coin_power_up = entity_j.GetComponent<CoinPowerUp>();
+		coin_power_up.applyPowerUp(entity_i);
+	} else if (entity_j.HasComponent<MassUpPowerUp>()) {
+		MassUpPowerUp& mass_up_power_up = entity_j.GetComponent<MassUpPowerUp>();
+		mass_up_power_up.applyPowerUp(entity_i);
+	}
+
+	game.report(GAME_EVENT_POWER_UP_TAKEN, entity_i, entity_j);
+	game.scene->m_Commands.destroy(entity_j);
+}
+
+void GameplaySystem::deform_hurt_bro(GameInstance& game, ECS_ENTT::Entity slingBro, float scaleX, float scaleY, float angle)
+{
+	ECS_ENTT::Scene* scene = game.scene;
+	auto* deformation = scene->m_Registry.try_get<Deformation>(slingBro);
+	if (!deformation || !deformation->active)
+		Deformation::start(scene, slingBro, scaleX, scaleY, angle, 100.0f);
+}
+
+void GameplaySystem::collidable_enemy_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity enemyEntity)
+{
+	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
+	Motion& enemyMotion = enemyEntity.GetComponent<Motion>();
+
+	// Don't count collisions when it is the enemy's turn
+	if (game.is_ai_turn)
+		return;
+
+	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
+	collidingBrosTurn.subPoints(POINTS_LOST_UPON_ENEMY_COLLISION);
+
+	// Knock the player away from the enemy and emit a "blood spray" particle effect. The knockback is
+	// drawn from the game's own stream, which the particles don't draw from
+	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(enemyMotion.position - slingBroMotion.position));
+	slingBroMotion.position -= 5.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	auto& broVelocity = slingBroMotion.velocity;
+	float broSpeed = glm::length(broVelocity);
+	broVelocity = broSpeed * -glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	broVelocity.x += (0.5f - game.random.Float()) * MAX_VELOCITY / 2.0f;
+	if (broSpeed > MAX_VELOCITY)
+		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
+
+	// Check orientation of character from the enemy and set knockback direction, particle velocity, & deformations correctly
+	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from spike tile to slingbro
+	glm::vec3 particleVelocity = glm::vec3(1.0f);
+	float particleSpeed = 0.1f;
+	if (angle > -PI / 4 && angle <= PI / 4) // bro to the right 
+		particleVelocity = glm::vec3(-particleSpeed, 0.0f, 0.0f);
+	else if (angle > PI / 4 && angle <= 3 * PI / 4)	// bro below 
+		particleVelocity = glm::vec3(0.0f, -particleSpeed, 0.0f);
+	else if (angle > 3 * PI / 4 && angle <= 5 * PI / 4)	// bro to the left 
+		particleVelocity = glm::vec3(particleSpeed, 0.0f, 0.0f);
+	else // bro above 
+		particleVelocity = glm::vec3(0.0f, particleSpeed, 0.0f);
+
+	// Deform the bro
+	deform_hurt_bro(game, slingBroEntity, 0.8f, 1.2f, angle);
+	game.report(GAME_EVENT_BRO_HURT, slingBroEntity, enemyEntity);
+
+	// Emit blood spray particles, unless the game runs without any
+	ParticleSystem* particleSystem = game.particles;
+	if (!particleSystem)
+		return;
+	ParticleProperties particle;
+	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
+	particle.position = slingBroMotion.position; +glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
+	particle.velocity = broVelocity / (100.0f * broSpeed);
+	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
+	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
+	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
+	particle.sizeBegin = 8.0f;
+	particle.sizeEnd = 0.1f;
+	particle.sizeVariation = 2.0f;
+	particle.lifeTimeMs = 2000.0f;
+	for (int i = 0; i < 100; i++)
+		particleSystem->Emit(particle);
+}
+
+void GameplaySystem::ground_spike_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity groundSpikeEntity)
+{
+	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
+	Motion& groundSpikeMotion = groundSpikeEntity.GetComponent<Motion>();
+
+	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
+	collidingBrosTurn.subPoints(POINTS_LOST_UPON_SPIKE_COLLISION);
+
+	// Knock the player away from the spike and emit a "blood spray" particle effect 
+	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(groundSpikeMotion.position - slingBroMotion.position));
+	slingBroMotion.position -= 1.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	auto& broVelocity = slingBroMotion.velocity;
+	float broSpeed = glm::length(broVelocity);
+	if (broVelocity.y > 0.0f)
+		broVelocity.y *= -1.0f - (game.random.Float() / 2.0f);
+	broVelocity.x *= -1.0f + ((0.5f - game.random.Float()) / 2.0f);
+	if (abs(broVelocity.x) < 200.0f)
+		broVelocity.x += (0.5f - game.random.Float()) * 1.5f * glm::length(broVelocity);
+	if (broSpeed > MAX_VELOCITY)
+		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
+
+	// Deform the character
+	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from ground spike to slingbro
+	deform_hurt_bro(game, slingBroEntity, 0.8f, 1.2f, angle);
+	game.report(GAME_EVENT_BRO_HURT, slingBroEntity, groundSpikeEntity);
+
+	// Emit blood spray particles, unless the game runs without any
+	ParticleSystem* particleSystem = game.particles;
+	if (!particleSystem)
+		return;
+	ParticleProperties particle;
+	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
+	particle.position = slingBroMotion.position + glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
+	particle.velocity = glm::vec3(0.0f, -0.05f, 0.0f);
+	particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f) / 2.0f;
+	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
+	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
+	particle.sizeBegin = 8.0f;
+	particle.sizeEnd = 4.0f;
+	particle.sizeVariation = 2.0f;
+	particle.lifeTimeMs = 4000.0f;
+	for (int i = 0; i < 20; i++)
+		particleSystem->Emit(particle);
+	particle.velocity = broVelocity / (10.0f * broSpeed);
+	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
+	for (int i = 0; i < 80; i++)
+		particleSystem->Emit(particle);
+}
+
+void GameplaySystem::tile_spike_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity tileSpikeEntity)
+{
+	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
+	Motion& tileSpikeMotion = tileSpikeEntity.GetComponent<Motion>();
+
+	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
+	collidingBrosTurn.subPoints(POINTS_LOST_UPON_SPIKE_COLLISION);
+
+	// Knock the player away from the spike tile and emit a "blood spray" particle effect 
+	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(tileSpikeMotion.position - slingBroMotion.position));
+	slingBroMotion.position += 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	auto& broVelocity = slingBroMotion.velocity;
+	float broSpeed = glm::length(broVelocity);
+	broVelocity = broSpeed * -glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	broVelocity.x += (0.5f - game.random.Float()) * MAX_VELOCITY / 2.0f;
+	if (broSpeed > MAX_VELOCITY)
+		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
+
+	// Check orientation of character from the spike tile and set knockback direction, particle velocity correctly
+	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from spike tile to slingbro
+	glm::vec3 particleVelocity = glm::vec3(1.0f);
+	float particleSpeed = 0.1f;
+	if (angle > -PI / 4 && angle <= PI / 4) // bro to the right of spike tile
+		particleVelocity = glm::vec3(-particleSpeed, 0.0f, 0.0f);
+	else if (angle > PI / 4 && angle <= 3 * PI / 4)	// bro below spike tile
+		particleVelocity = glm::vec3(0.0f, -particleSpeed, 0.0f);
+	else if (angle > 3 * PI / 4 && angle <= 5 * PI / 4)	// bro to the left of spike tile
+		particleVelocity = glm::vec3(particleSpeed, 0.0f, 0.0f);
+	else // bro above spike tile
+		particleVelocity = glm::vec3(0.0f, particleSpeed, 0.0f);
+
+	// Deform the character
+	deform_hurt_bro(game, slingBroEntity, 0.8f, 1.2f, angle);
+	game.report(GAME_EVENT_BRO_HURT, slingBroEntity, tileSpikeEntity);
+
+	// Emit blood spray particles, unless the game runs without any
+	ParticleSystem* particleSystem = game.particles;
+	if (!particleSystem)
+		return;
+	ParticleProperties particle;
+	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
+	particle.position = slingBroMotion.position + glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
+	particle.velocity = particleVelocity;
+	particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f) / 2.0f;
+	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
+	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
+	particle.sizeBegin = 8.0f;
+	particle.sizeEnd = 4.0f;
+	particle.sizeVariation = 2.0f;
+	particle.lifeTimeMs = 4000.0f;
+	for (int i = 0; i < 20; i++)
+		particleSystem->Emit(particle);
+	particle.velocity = broVelocity / (10.0f * broSpeed);
+	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
+	for (int i = 0; i < 80; i++)
+		particleSystem->Emit(particle);
+}
+
+void GameplaySystem::projectile_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity projectileEntity)
+{
+	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
+	Motion& projectileMotion = projectileEntity.GetComponent<Motion>();
+
+	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
+	collidingBrosTurn.subPoints(POINTS_LOST_BASIC_PROJECTILE);
+
+	// Knock the player away from the projectile
+	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(projectileMotion.position - slingBroMotion.position));
+	slingBroMotion.position -= 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	auto& broVelocity = slingBroMotion.velocity;
+	auto& projectileVelocity = projectileMotion.velocity;
+	float broSpeed = glm::length(broVelocity);
+	float projectileSpeed = glm::length(projectileVelocity);
+	broVelocity = (broSpeed + projectileSpeed) * -2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+
+	if (broSpeed > MAX_PROJECTILE_KNOCKBACK_VELOCITY)
+		broVelocity = (broVelocity / broSpeed) * MAX_PROJECTILE_KNOCKBACK_VELOCITY;
+
+	// Deform the character
+	float angle = atan(dispVecNorm.y, dispVecNorm.x);
+	deform_hurt_bro(game, slingBroEntity, 0.8f, 1.2f, angle);
+	game.report(GAME_EVENT_BRO_HURT, slingBroEntity, projectileEntity);
+
+	// Released last since it takes away the projectile's motion
+	ProjectilePool::release(projectileEntity);
+}
+
+void GameplaySystem::helge_projectile_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity helgeProjectileEntity)
+{
+	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
+	Motion& helgeProjectileMotion = helgeProjectileEntity.GetComponent<Motion>();
+
+	auto& turn = slingBroEntity.GetComponent<Turn>();
+	turn.subPoints(POINTS_LOST_HELGE_PROJECTILE);
+
+	// Knock the player away from Helge's projectile 
+	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(helgeProjectileMotion.position - slingBroMotion.position));
+	slingBroMotion.position -= 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+	auto& broVelocity = slingBroMotion.velocity;
+	auto& projectileVelocity = helgeProjectileMotion.velocity;
+	float broSpeed = glm::length(broVelocity);
+	float projectileSpeed = glm::length(projectileVelocity);
+	broVelocity = (broSpeed + projectileSpeed) * -2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
+
+	if (broSpeed > MAX_PROJECTILE_KNOCKBACK_VELOCITY)
+		broVelocity = (broVelocity / broSpeed) * MAX_PROJECTILE_KNOCKBACK_VELOCITY;
+
+	// Deform the character
+	float angle = atan(dispVecNorm.y, dispVecNorm.x);
+	deform_hurt_bro(game, slingBroEntity, 0.6f, 1.4f, angle);
+	game.report(GAME_EVENT_BRO_HURT, slingBroEntity, helgeProjectileEntity);
+
+	// Released last since it takes away the projectile's motion
+	ProjectilePool::release(helgeProjectileEntity);
+}
+
+void GameplaySystem::beehive_collision_listener(GameInstance& game, ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity beeHiveEntity)
+{
+	// Give points for collecting honey from the hive, once per bro
+	BeeHiveEnemy& beeHiveComponent = beeHiveEntity.GetComponent<BeeHiveEnemy>();
+	if (beeHiveComponent.HasBeenHarvestedByPlayer(slingBroEntity.GetEntityID()))
+		return;
+	Turn& turnComponent = slingBroEntity.GetComponent<Turn>();
+	turnComponent.points += POINTS_GAINED_HARVESTING_HONEY;
+	beeHiveComponent.harvestedByPlayers.push_back(slingBroEntity.GetEntityID());
+
+	// Emit some honey gloop particles, unless the game runs without any
+	ParticleSystem* particleSystem = game.particles;
+	if (!particleSystem)
+		return;
+	ParticleProperties particle;
+	particle.position = beeHiveEntity.GetComponent<Motion>().position;
+	particle.velocity = glm::vec3(0.0f, -0.05f, 0.0f);;
+	particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f);
+	particle.colourBegin = glm::vec4(250.0f / 255.0f, 189.0f / 255.0f, 42.0f / 255.0f, 1.0f);
+	particle.colourEnd = glm::vec4(200.0f / 255.0f, 139.0f / 255.0f, 0.0f / 255.0f, 0.2f);
+	particle.sizeBegin = 20.0f;
+	particle.sizeEnd = 2.0f;
+	particle.sizeVariation = 2.0f;
+	particle.lifeTimeMs = 4000.0f;
+	for (int i = 0; i < 100; i++)
+		particleSystem->Emit(particle);
+}
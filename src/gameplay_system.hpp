@@ -0,0 +1,31 @@
+#pragma once
+
+#include "common.hpp"
+#include "Entity.h"
+
+struct GameInstance;
+
+// The rules of the game that apply when entities collide: damage and knockback, power-ups, harvesting
+// honey and reaching the goal. They only touch the GameInstance they are given, so every game plays by
+// them, and leave sounds and level changes to the game's host through its events.
+class GameplaySystem
+{
+public:
+	// Subscribes the rules to the collisions of a game
+	static void attach(GameInstance& game);
+
+	// Collisions between bros and what hurts, helps or moves them on - callback function, listening to PhysicsSystem::Collisions
+	static void collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall);
+
+private:
+	static void powerup_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void ground_spike_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void tile_spike_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void collidable_enemy_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void projectile_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void helge_projectile_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+	static void beehive_collision_listener(GameInstance& game, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+
+	// Deforms a bro hurt by something, unless it is still deformed from the previous hit
+	static void deform_hurt_bro(GameInstance& game, ECS_ENTT::Entity slingBro, float scaleX, float scaleY, float angle);
+};
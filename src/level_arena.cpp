@@ -0,0 +1,26 @@
+#include "level_arena.hpp"
+
+LevelArena::LevelArena()
+	: m_Resource(LEVEL_ARENA_INITIAL_SIZE)
+{
+}
+
+void* LevelArena::do_allocate(size_t bytes, size_t alignment)
+{
+	m_BytesAllocated += bytes;
+	m_NumAllocations++;
+	return m_Resource.allocate(bytes, alignment);
+}
+
+void LevelArena::do_deallocate(void* p, size_t bytes, size_t alignment)
+{
+	// Only released along with the whole arena
+	(void)p;
+	(void)bytes;
+	(void)alignment;
+}
+
+bool LevelArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+{
+	return this == &other;
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <cstddef>
+#include <memory_resource>
+
+// Initial block of a level's arena, further blocks grow geometrically
+const size_t LEVEL_ARENA_INITIAL_SIZE = 64 * 1024;
+
+// Monotonic arena for the allocations that live as long as a level, e.g. its map and tile grid.
+// Freeing is a no-op, everything is released at once with the scene. State of entities that can be
+// destroyed and created again within a level goes to the scene's entity pool on top of the arena.
+class LevelArena : public std::pmr::memory_resource
+{
+public:
+	LevelArena();
+
+	LevelArena(const LevelArena&) = delete;
+	LevelArena& operator=(const LevelArena&) = delete;
+
+	// Bytes handed out since the level was loaded, including those already freed
+	size_t GetBytesAllocated() const { return m_BytesAllocated; }
+
+	size_t GetNumAllocations() const { return m_NumAllocations; }
+
+private:
+	void* do_allocate(size_t bytes, size_t alignment) override;
+
+	void do_deallocate(void* p, size_t bytes, size_t alignment) override;
+
+	bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override;
+
+	std::pmr::monotonic_buffer_resource m_Resource;
+	size_t m_BytesAllocated = 0;
+	size_t m_NumAllocations = 0;
+};
@@ -34,23 +34,16 @@
 #include <entities/helge_projectile.hpp>
 #include <entities/parallax_background.hpp>
 #include "level_manager.hpp"
+#include "save_writer.hpp"
+#include "material_table.hpp"
+#include "prefab_table.hpp"
 
+// Factories of the level map types with behaviour of their own, all others are prefabs
 typedef ECS_ENTT::Entity (*fn)(vec3, ECS_ENTT::Scene*);
 typedef std::map<std::string, fn> FunctionMap;
 const FunctionMap fns =
 		{
-				{T0, StartTile::createStartTile},
-				{T1, GoalTile::createGoalTile},
-				{T2, GroundTile::createGroundTile},
-				{T3, GrassyTile::createGrassyTile},
-				{T4, LavaTile::createLavaTile},
 				{T5, WindyGrass::createGrass},
-				{T6, SandTile::createSandTile},
-				{T7, GlassTile::createGlassTile},
-				{T8, SnowyTile::createSnowyTile},
-				{T9, IceTile::createIceTile},
-				{H0, HazardTileSpike::createHazardTileSpike},
-				{H1, HazardSpike::createSpikeHazard},
 				{E0, BasicEnemy::createBasicEnemy},
 				{E1, SnailEnemy::createSnailEnemy},
 				{E2, BugDroidEnemy::createBugDroidEnemy},
@@ -58,17 +51,26 @@ const FunctionMap fns =
 				{E4, BluebEnemy::createBluebEnemy},
 				{E5, BeeHiveEnemy::createBeeHiveEnemy},
 				{E6, HelgeEnemy::createHelgeEnemy},
-				{P0, SpeedPowerUp::createSpeedPowerUp},
-				{P1, SizeUpPowerUp::createSizeUpPowerUp},
-				{P2, SizeDownPowerUp::createSizeDownPowerUp},
-				{P3, CoinPowerUp::createCoinPowerUp},
-				{P4, MassUpPowerUp::createMassUpPowerUp},
 				{S0, SlingBro::createOrangeSlingBro},
 				{S1, SlingBro::createPinkSlingBro},
 				{X0, Projectile::createProjectile},
 				{X1, HelgeProjectile::createHelgeProjectile}
 		};
 
+// Writes user level progress off the main thread
+static SaveWriter saveWriter;
+
+// Motions of the entities of each prefab type that a level creates, by type key
+typedef std::map<std::string, std::vector<Motion>> PrefabBatches;
+
+// Creates every entity of a level's prefab types with one insert per component and type
+static void instantiate_batches(const PrefabBatches& batches, ECS_ENTT::Scene* scene)
+{
+	std::vector<entt::entity> created;
+	for (const auto& [type_key, motions] : batches)
+		PrefabTable::instantiate(*PrefabTable::find(type_key), scene, motions, created);
+}
+
 // See: https://github.com/jbeder/yaml-cpp/wiki/Tutorial#converting-tofrom-native-data-types
 namespace YAML
 {
@@ -196,6 +198,8 @@ void LevelManager::create_level(const std::string& file_name)
 		scene->dialogue_box_names = dialogue_boxes;
 	}
 
+	// Entities of prefab types are created together once the whole map is read
+	PrefabBatches batches;
 	for (int i = 0; i < rows.size(); i++) // Row index
 	{
 		// Convert each key to entity in the row and add to scene graph and registry
@@ -210,13 +214,19 @@ void LevelManager::create_level(const std::string& file_name)
 			// Calculate position
 			vec3 position = vec3(j * SPRITE_SCALE, i * SPRITE_SCALE, 0.f);
 
+			if (const Prefab* prefab = PrefabTable::find(key))
+			{
+				batches[key].push_back(PrefabTable::motion(*prefab, position));
+				continue;
+			}
+
 			// Map the key in the level map to the entity create function and create the entity
-			const auto& create_entity = fns.at(key);
-			(*create_entity)(position, scene);
+			create_entity(key, position, scene);
 
 			//printf("Created entity '%s' in scene at (%f,%f)\n", key.c_str(), position.x, position.y);
 		}
 	}
+	instantiate_batches(batches, scene);
 
 	// First player starts by default
 	scene->SetPlayer(0);
@@ -286,7 +296,8 @@ ECS_ENTT::Scene *LevelManager::load_level(const std::string& file_path, Camera*
 		}
 	}
 
-	// Load entities
+	// Load entities, those of prefab types are created together once the whole list is read
+	PrefabBatches batches;
 	auto entities = file[ENTITIES_KEY];
 	for (auto entity : entities)
 	{
@@ -300,9 +311,19 @@ ECS_ENTT::Scene *LevelManager::load_level(const std::string& file_path, Camera*
 		auto velocity = motion[VELOCITY_KEY].as<glm::vec3>();
 		auto scale = motion[SCALE_KEY].as<glm::vec3>();
 
+		// Prefabs are only made of data components, so their motion is all there is to load
+		if (PrefabTable::find(key))
+		{
+			Motion& e_motion = batches[key].emplace_back();
+			e_motion.position = position;
+			e_motion.angle = angle;
+			e_motion.velocity = velocity;
+			e_motion.scale = scale;
+			continue;
+		}
+
 		// Map the key in the level map to the entity create function and create the entity
-		const auto& create_entity = fns.at(key);
-		auto e = (*create_entity)(position, scene);
+		auto e = create_entity(key, position, scene);
 
 		// Set motion component
 		auto& e_motion = e.GetComponent<Motion>();
@@ -380,6 +401,7 @@ ECS_ENTT::Scene *LevelManager::load_level(const std::string& file_path, Camera*
 
 		//printf("Loaded entity '%s' into scene at (%f,%f)\n", key.c_str(), position.x, position.y);
 	}
+	instantiate_batches(batches, scene);
 
 	// Add a background to the loaded scene based on filename in yaml file
 	if (!bg_src.empty()) // ignore if no background image has been set
@@ -391,10 +413,120 @@ ECS_ENTT::Scene *LevelManager::load_level(const std::string& file_path, Camera*
 	return scene;
 }
 
+SavedGame LevelManager::snapshot(ECS_ENTT::Scene* scene)
+{
+	SavedGame save;
+	save.levelId = scene->m_Id;
+	save.player = scene->GetPlayer();
+	save.numPlayers = scene->GetNumPlayers();
+
+	// Save current dialogue box if exists
+	if (!scene->current_dialogue_box.empty())
+		save.dialogueBoxes.push_back(scene->current_dialogue_box);
+	std::queue<std::string> names = scene->GetDialogueBoxNames();
+	while (!names.empty())
+	{
+		save.dialogueBoxes.push_back(names.front());
+		names.pop();
+	}
+
+	// Tiles and other physics-ignoring entities never change, so the level file already has them
+	auto view = scene->m_Registry.view<Motion>(entt::exclude<IgnorePhysics, IgnoreSave>);
+	save.entities.reserve(view.size_hint());
+	for (auto id : view)
+	{
+		auto entity = ECS_ENTT::Entity(id, scene);
+
+		SavedEntity saved;
+		saved.type = to_type_key(entity);
+		saved.motion = view.get<Motion>(id);
+		if (entity.HasComponent<Turn>())
+			saved.turn = entity.GetComponent<Turn>();
+		if (entity.HasComponent<Mass>())
+			saved.mass = entity.GetComponent<Mass>().value;
+		if (entity.HasComponent<SizeChanged>())
+			saved.sizeChangedTurnsRemaining = entity.GetComponent<SizeChanged>().turnsRemaining;
+		if (entity.HasComponent<MassChanged>())
+			saved.massChangedTurnsRemaining = entity.GetComponent<MassChanged>().turnsRemaining;
+		if (entity.HasComponent<AI>())
+		{
+			const auto& ai = entity.GetComponent<AI>();
+			saved.aiCountdown = ai.countdown;
+			saved.aiTarget = ai.target;
+		}
+		save.entities.push_back(std::move(saved));
+	}
+	return save;
+}
+
+void LevelManager::restore(const SavedGame& save, ECS_ENTT::Scene* scene)
+{
+	// Replace the scene's dynamic entities with the saved ones. Hives get a new swarm when they
+	// are recreated, and those of hives destroyed before the game was saved mustn't come back.
+	ParticleSystem::GetInstance()->clearBeeSwarms(scene);
+	auto current = scene->m_Registry.view<Motion>(entt::exclude<IgnorePhysics, IgnoreSave>);
+	scene->m_Registry.destroy(current.begin(), current.end());
+
+	scene->SetPlayer(save.player);
+	scene->SetNumPlayer(save.numPlayers);
+	scene->dialogue_box_names = std::queue<std::string>();
+	for (const auto& name : save.dialogueBoxes)
+		scene->dialogue_box_names.push(name);
+
+	for (const auto& saved : save.entities)
+	{
+		auto e = create_entity(saved.type, saved.motion.position, scene);
+		e.GetComponent<Motion>() = saved.motion;
+
+		if (saved.turn)
+		{
+			auto& e_turn = e.GetComponent<Turn>();
+			e_turn.order = saved.turn->order;
+			e_turn.slung = saved.turn->slung;
+			e_turn.points = saved.turn->points;
+			e_turn.countdown = saved.turn->countdown;
+		}
+		if (saved.mass)
+			e.GetComponent<Mass>().value = *saved.mass;
+		if (saved.sizeChangedTurnsRemaining)
+			e.AddComponent<SizeChanged>().turnsRemaining = *saved.sizeChangedTurnsRemaining;
+		if (saved.massChangedTurnsRemaining)
+			e.AddComponent<MassChanged>().turnsRemaining = *saved.massChangedTurnsRemaining;
+		if (saved.aiCountdown)
+		{
+			// Enemy entities should be created with the AI component
+			auto& e_ai = e.HasComponent<AI>() ? e.GetComponent<AI>() : e.AddComponent<AI>();
+			e_ai.countdown = *saved.aiCountdown;
+			e_ai.target = saved.aiTarget;
+		}
+	}
+}
+
 void LevelManager::save_level(ECS_ENTT::Scene* scene)
 {
 	// Overwrites over old progress
-	save_level(scene, saved_path(yaml_file(SAVE_FILE_NAME)));
+	saveWriter.write_async(snapshot(scene), saved_path(save_file(SAVE_FILE_NAME)));
+}
+
+ECS_ENTT::Scene* LevelManager::load_saved_game(const std::string& file_path, Camera* camera)
+{
+	// Don't read a save that is still being written
+	saveWriter.wait();
+
+	auto save = SaveWriter::read(file_path);
+	if (!save)
+	{
+		fprintf(stderr, "Could not read saved data at '%s'\n", file_path.c_str());
+		return nullptr;
+	}
+
+	auto* scene = load_level(levels_path(yaml_file(save->levelId)), camera);
+	if (scene == nullptr)
+		return nullptr;
+
+	restore(*save, scene);
+	assert(ParticleSystem::GetInstance()->NumBeeSwarms(scene) == scene->m_Registry.size<BeeHiveEnemy>() && "Every hive should have exactly one swarm");
+	return scene;
 }
 
 void LevelManager::save_level(ECS_ENTT::Scene *scene, const std::string &file_path)
@@ -589,6 +721,24 @@ void LevelManager::save_level(ECS_ENTT::Scene *scene, const std::string &file_pa
 	printf("Saved to %s\n", file_path.c_str());
 }
 
+ECS_ENTT::Entity LevelManager::create_entity(const std::string& type_key, vec3 position, ECS_ENTT::Scene* scene)
+{
+	if (const Prefab* prefab = PrefabTable::find(type_key))
+	{
+		std::vector<entt::entity> created;
+		PrefabTable::instantiate(*prefab, scene, { PrefabTable::motion(*prefab, position) }, created);
+		return ECS_ENTT::Entity(created.front(), scene);
+	}
+
+	const auto& create_fn = fns.at(type_key);
+	auto entity = (*create_fn)(position, scene);
+
+	// Tiles get the material of their type from the material table
+	if (uint8_t material = MaterialTable::find(type_key))
+		entity.AddComponent<Material>(material);
+	return entity;
+}
+
 std::string LevelManager::to_type_key(ECS_ENTT::Entity entity) {
 	if (entity.HasComponent<StartTile>()) return T0;
 	if (entity.HasComponent<GoalTile>()) return T1;
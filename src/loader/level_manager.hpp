@@ -1,5 +1,7 @@
 #pragma once
 
+#include "save_writer.hpp"
+
 #include <yaml-cpp/yaml.h>
 
 // The keys in the yaml file to parse
@@ -107,22 +109,48 @@ class LevelManager
 		static ECS_ENTT::Scene* load_level(const std::string& file_path, Camera* camera);
 
 		/**
-		 * Saves a scene into a Slingbro level yaml file to load in the future.
-		 * Used to save user level progress.
+		 * Saves user level progress as a reference to the level file plus the
+		 * state of its dynamic entities. The save file is written in the background.
 		 *
 		 * @param scene The scene to save
 		 */
 		static void save_level(ECS_ENTT::Scene* scene);
 
-	private:
 		/**
-		 * Saves a scene into a Slingbro level yaml file to load in the future
-		 * at the specified path. Used to save created levels.
+		 * Loads user level progress saved with save_level into a Scene.
 		 *
-		 * @param scene The scene to save
-		 * @param file_path The path to save the yaml file
+		 * @param file_path The path to the save file
+		 * @param camera A pointer to a camera that you want the loaded scene to use as its active camera
+		 * @return The created scene of the saved level, or nullptr if the save couldn't be read
 		 */
-		static void save_level(ECS_ENTT::Scene* scene, const std::string& file_path);
+		static ECS_ENTT::Scene* load_saved_game(const std::string& file_path, Camera* camera);
+
+		/**
+		 * Captures the state of a scene's dynamic entities, which is what save_level writes
+		 *
+		 * @param scene The scene to capture
+		 * @return The state of the scene, referring to its level file for everything else
+		 */
+		static SavedGame snapshot(ECS_ENTT::Scene* scene);
+
+		/**
+		 * Replaces the dynamic entities of a scene with those of a saved game.
+		 * The scene must have been loaded from the level the game was saved in.
+		 *
+		 * @param save The state to restore
+		 * @param scene The scene to restore it into
+		 */
+		static void restore(const SavedGame& save, ECS_ENTT::Scene* scene);
+
+		/**
+		 * Creates an entity of the given level map type in a scene
+		 *
+		 * @param type_key The level map key of the entity type to create
+		 * @param position The position to create the entity at
+		 * @param scene The scene to create the entity in
+		 * @return The created entity
+		 */
+		static ECS_ENTT::Entity create_entity(const std::string& type_key, vec3 position, ECS_ENTT::Scene* scene);
 
 		/**
 		 * Maps the given entity to a level map key
@@ -132,6 +160,16 @@ class LevelManager
 		 */
 		static std::string to_type_key(ECS_ENTT::Entity entity);
 
+	private:
+		/**
+		 * Saves a scene into a Slingbro level yaml file to load in the future
+		 * at the specified path. Used to save created levels.
+		 *
+		 * @param scene The scene to save
+		 * @param file_path The path to save the yaml file
+		 */
+		static void save_level(ECS_ENTT::Scene* scene, const std::string& file_path);
+
 		/**
 		 * Splits a string into a vector by the provided delimiter.
 		 * See: https://stackoverflow.com/a/236803
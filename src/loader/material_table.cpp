@@ -0,0 +1,58 @@
+#include "material_table.hpp"
+
+#include <yaml-cpp/yaml.h>
+
+std::vector<MaterialProperties> MaterialTable::s_Materials(1);
+std::unordered_map<std::string, uint8_t> MaterialTable::s_TypeMaterials;
+
+namespace
+{
+	ParticleEmitter to_particle_emitter(const std::string& name)
+	{
+		if (name == "dirt") return EMITTER_DIRT;
+		if (name == "grass") return EMITTER_GRASS;
+		if (name == "lava") return EMITTER_LAVA;
+		return EMITTER_NONE;
+	}
+}
+
+void MaterialTable::load(const std::string& file_path)
+{
+	YAML::Node file = YAML::LoadFile(file_path);
+	auto materials = file["materials"];
+	assert(materials && materials.IsSequence());
+
+	s_Materials.resize(1);
+	s_TypeMaterials.clear();
+
+	std::unordered_map<std::string, uint8_t> ids;
+	for (auto node : materials)
+	{
+		assert(s_Materials.size() <= UINT8_MAX);
+		MaterialProperties material;
+		material.name = node["name"].as<std::string>();
+		material.restitution = node["restitution"].as<float>(material.restitution);
+		material.drag = node["drag"].as<float>(material.drag);
+		material.rain_drag = node["rain_drag"].as<float>(material.drag);
+		material.sound = node["sound"].as<std::string>("");
+		material.volume = node["volume"].as<int>(material.volume);
+		material.particles = to_particle_emitter(node["particles"].as<std::string>("none"));
+
+		ids[material.name] = (uint8_t)s_Materials.size();
+		s_Materials.push_back(material);
+	}
+
+	for (auto tile : file["tiles"])
+	{
+		auto id = ids.find(tile.second.as<std::string>());
+		assert(id != ids.end() && "Tile uses a material that isn't defined");
+		if (id != ids.end())
+			s_TypeMaterials[tile.first.as<std::string>()] = id->second;
+	}
+}
+
+uint8_t MaterialTable::find(const std::string& type_key)
+{
+	auto it = s_TypeMaterials.find(type_key);
+	return it != s_TypeMaterials.end() ? it->second : 0;
+}
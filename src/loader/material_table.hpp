@@ -0,0 +1,59 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const std::string MATERIALS_FILE_NAME = "materials";
+
+// Particle effects a material can emit when a bro hits it
+enum ParticleEmitter : uint8_t
+{
+	EMITTER_NONE,
+	EMITTER_DIRT,
+	EMITTER_GRASS,
+	EMITTER_LAVA
+};
+
+// How a surface responds to the bodies touching it, see data/config/materials.yaml
+struct MaterialProperties
+{
+	std::string name = "default";
+	float restitution = -VELOCITY_BOUNCE_MULTIPLIER;
+	float drag = 1.f;
+	float rain_drag = 1.f;
+	std::string sound; // Empty if hitting the material makes no sound
+	int volume = 128;
+	ParticleEmitter particles = EMITTER_NONE;
+};
+
+// Table of the materials of the game, indexed by the id stored in Material components.
+// Id 0 is the default material of entities without one.
+class MaterialTable
+{
+public:
+	/**
+	 * Replaces the table with the materials of a config file
+	 *
+	 * @param file_path The path to the materials config file
+	 */
+	static void load(const std::string& file_path);
+
+	/**
+	 * Looks up the material entities of a level map type are made of
+	 *
+	 * @param type_key The level map key of the entity type
+	 * @return The material id, or 0 if the type has no material
+	 */
+	static uint8_t find(const std::string& type_key);
+
+	static const MaterialProperties& get(uint8_t id) { return s_Materials[id < s_Materials.size() ? id : 0]; }
+
+	static size_t size() { return s_Materials.size(); }
+
+private:
+	static std::vector<MaterialProperties> s_Materials;
+	static std::unordered_map<std::string, uint8_t> s_TypeMaterials;
+};
@@ -0,0 +1,154 @@
+#include "prefab_table.hpp"
+#include "material_table.hpp"
+#include "render.hpp"
+
+#include <entities/powerup.hpp>
+#include <entities/start_tile.hpp>
+#include <entities/goal_tile.hpp>
+#include <entities/ground_tile.hpp>
+#include <entities/grassy_tile.hpp>
+#include <entities/lava_tile.hpp>
+#include <entities/sand_tile.hpp>
+#include <entities/glass_tile.hpp>
+#include <entities/snowy_tile.hpp>
+#include <entities/ice_tile.hpp>
+#include <entities/hazard_tile_spike.hpp>
+#include <entities/spike_hazard.hpp>
+#include <entities/speed_powerup.hpp>
+#include <entities/size_up_powerup.hpp>
+#include <entities/size_down_powerup.hpp>
+#include <entities/coin_powerup.hpp>
+#include <entities/mass_up_powerup.hpp>
+
+#include <yaml-cpp/yaml.h>
+
+std::unordered_map<std::string, Prefab> PrefabTable::s_Prefabs;
+
+namespace
+{
+	template<typename Component>
+	void insert_default(entt::registry& registry, const std::vector<entt::entity>& entities)
+	{
+		registry.insert<Component>(entities.begin(), entities.end());
+	}
+
+	// Components a prefab can be made of, by their name in the config file
+	const std::unordered_map<std::string, PrefabComponentFn> COMPONENTS =
+			{
+					{"tile", insert_default<Tile>},
+					{"bouncy_tile", insert_default<BouncyTile>},
+					{"hazard", insert_default<Hazard>},
+					{"ignore_physics", insert_default<IgnorePhysics>},
+					{"power_up", insert_default<PowerUp>},
+					{"start_tile", insert_default<StartTile>},
+					{"goal_tile", insert_default<GoalTile>},
+					{"ground_tile", insert_default<GroundTile>},
+					{"grassy_tile", insert_default<GrassyTile>},
+					{"lava_tile", insert_default<LavaTile>},
+					{"sand_tile", insert_default<SandTile>},
+					{"glass_tile", insert_default<GlassTile>},
+					{"snowy_tile", insert_default<SnowyTile>},
+					{"ice_tile", insert_default<IceTile>},
+					{"hazard_tile_spike", insert_default<HazardTileSpike>},
+					{"hazard_spike", insert_default<HazardSpike>},
+					{"speed_power_up", insert_default<SpeedPowerUp>},
+					{"size_up_power_up", insert_default<SizeUpPowerUp>},
+					{"size_down_power_up", insert_default<SizeDownPowerUp>},
+					{"coin_power_up", insert_default<CoinPowerUp>},
+					{"mass_up_power_up", insert_default<MassUpPowerUp>}
+			};
+
+	uint16_t to_layers(const YAML::Node& node)
+	{
+		uint16_t layers = LAYER_NONE;
+		for (auto layer : node)
+		{
+			auto name = layer.as<std::string>();
+			if (name == "bro") layers |= LAYER_BRO;
+			else if (name == "enemy") layers |= LAYER_ENEMY;
+			else if (name == "snail") layers |= LAYER_SNAIL;
+			else if (name == "projectile") layers |= LAYER_PROJECTILE;
+			else if (name == "tile") layers |= LAYER_TILE;
+			else if (name == "trigger") layers |= LAYER_TRIGGER;
+			else assert(false && "Unknown collision layer");
+		}
+		return layers;
+	}
+}
+
+void PrefabTable::load(const std::string& file_path)
+{
+	YAML::Node file = YAML::LoadFile(file_path);
+	auto prefabs = file["prefabs"];
+	assert(prefabs && prefabs.IsMap());
+
+	s_Prefabs.clear();
+	for (auto node : prefabs)
+	{
+		Prefab prefab;
+		prefab.type_key = node.first.as<std::string>();
+		prefab.sprite = node.second["sprite"].as<std::string>();
+		prefab.resource = resource_key(prefab.sprite);
+		prefab.scale = node.second["scale"].as<float>(prefab.scale);
+		prefab.collider.layer = to_layers(node.second["layer"]);
+		prefab.collider.activatedBy = to_layers(node.second["activated_by"]);
+
+		for (auto component : node.second["components"])
+		{
+			auto insert = COMPONENTS.find(component.as<std::string>());
+			assert(insert != COMPONENTS.end() && "Prefab uses a component that can't be inserted");
+			if (insert != COMPONENTS.end())
+				prefab.components.push_back(insert->second);
+		}
+
+		s_Prefabs[prefab.type_key] = std::move(prefab);
+	}
+}
+
+const Prefab* PrefabTable::find(const std::string& type_key)
+{
+	auto it = s_Prefabs.find(type_key);
+	return it != s_Prefabs.end() ? &it->second : nullptr;
+}
+
+ShadedMesh& PrefabTable::mesh(const Prefab& prefab)
+{
+	ShadedMesh& resource = cache_resource(prefab.resource);
+	if (resource.effect.program.resource == 0)
+		RenderSystem::createSprite(resource, textures_path(prefab.sprite + ".png"), "textured");
+	return resource;
+}
+
+Motion PrefabTable::motion(const Prefab& prefab, vec3 position)
+{
+	const ShadedMesh& resource = mesh(prefab);
+
+	Motion motion;
+	motion.position = position;
+	motion.angle = 0.0f;
+	motion.velocity = { 0.0f, 0.0f, 0.0f };
+	motion.scale = { resource.mesh.original_size.x * SPRITE_SCALE * prefab.scale, resource.mesh.original_size.y * SPRITE_SCALE * prefab.scale, 1.0f };
+	return motion;
+}
+
+void PrefabTable::instantiate(const Prefab& prefab, ECS_ENTT::Scene* scene, const std::vector<Motion>& motions, std::vector<entt::entity>& entities)
+{
+	auto& registry = scene->m_Registry;
+	ShadedMesh& resource = mesh(prefab);
+	resource.texture.color = glm::vec4{ 1.0f, 1.0f, 1.0f, 1.0f };
+
+	entities.resize(motions.size());
+	registry.create(entities.begin(), entities.end());
+	registry.insert<ShadedMeshRef>(entities.begin(), entities.end(), ShadedMeshRef(resource));
+
+	// Tiles register themselves in the scene's grid when tagged, so their motion has to come first
+	registry.insert<Motion>(entities.begin(), entities.end(), motions.begin(), motions.end());
+	if (prefab.collider.layer != LAYER_NONE)
+		registry.insert<Collider>(entities.begin(), entities.end(), prefab.collider);
+	for (auto insert : prefab.components)
+		insert(registry, entities);
+
+	// Tiles get the material of their type from the material table
+	if (uint8_t material = MaterialTable::find(prefab.type_key))
+		registry.insert<Material>(entities.begin(), entities.end(), Material{ material });
+}
@@ -0,0 +1,70 @@
+#pragma once
+
+#include "common.hpp"
+#include "render_components.hpp"
+#include "Scene.h"
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+static const std::string PREFABS_FILE_NAME = "prefabs";
+
+// Adds a default valued component to every entity of a batch
+using PrefabComponentFn = void (*)(entt::registry& registry, const std::vector<entt::entity>& entities);
+
+// Entity type of the level map that is only made of data components, see data/config/prefabs.yaml
+struct Prefab
+{
+	std::string type_key;
+	std::string sprite;
+	ResourceKey resource = 0;
+	float scale = 1.f;
+	Collider collider; // Not added if it has no layer
+	std::vector<PrefabComponentFn> components;
+};
+
+// Table of the prefabs of the level map types, compiled once from their config file so that
+// levels can create all entities of a type with one insert per component
+class PrefabTable
+{
+public:
+	/**
+	 * Replaces the table with the prefabs of a config file
+	 *
+	 * @param file_path The path to the prefabs config file
+	 */
+	static void load(const std::string& file_path);
+
+	/**
+	 * Looks up the prefab of a level map type
+	 *
+	 * @param type_key The level map key of the entity type
+	 * @return The prefab, or nullptr if entities of the type are built by a factory
+	 */
+	static const Prefab* find(const std::string& type_key);
+
+	/**
+	 * Gives the motion an entity of the prefab starts with, loading the prefab's sprite on first use
+	 *
+	 * @param prefab The prefab of the entity
+	 * @param position The position of the entity
+	 * @return The motion of the entity
+	 */
+	static Motion motion(const Prefab& prefab, vec3 position);
+
+	/**
+	 * Creates a batch of entities of a prefab in a scene, one per motion
+	 *
+	 * @param prefab The prefab of the entities
+	 * @param scene The scene to create the entities in
+	 * @param motions The motions of the entities
+	 * @param entities Receives the created entities, in the order of their motions
+	 */
+	static void instantiate(const Prefab& prefab, ECS_ENTT::Scene* scene, const std::vector<Motion>& motions, std::vector<entt::entity>& entities);
+
+private:
+	static ShadedMesh& mesh(const Prefab& prefab);
+
+	static std::unordered_map<std::string, Prefab> s_Prefabs;
+};
@@ -0,0 +1,248 @@
+#include "save_writer.hpp"
+
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace
+{
+	// File header, bump the version whenever the layout below changes
+	const char SAVE_MAGIC[4] = { 'S', 'L', 'B', 'S' };
+	const uint16_t SAVE_VERSION = 1;
+
+	// Which optional components follow an entity's motion
+	enum SavedComponent : uint8_t
+	{
+		SAVED_TURN = 1 << 0,
+		SAVED_MASS = 1 << 1,
+		SAVED_SIZE_CHANGED = 1 << 2,
+		SAVED_MASS_CHANGED = 1 << 3,
+		SAVED_AI = 1 << 4,
+		SAVED_AI_TARGET = 1 << 5,
+	};
+
+	template<typename T>
+	void put(std::vector<char>& out, const T& value)
+	{
+		static_assert(std::is_trivially_copyable<T>::value, "Only plain values can be written directly");
+		const char* bytes = reinterpret_cast<const char*>(&value);
+		out.insert(out.end(), bytes, bytes + sizeof(T));
+	}
+
+	void put_string(std::vector<char>& out, const std::string& s)
+	{
+		put(out, (uint32_t)s.size());
+		out.insert(out.end(), s.begin(), s.end());
+	}
+
+	// Bounds checked cursor over the bytes of a save file
+	struct Reader
+	{
+		const char* cursor;
+		const char* end;
+
+		template<typename T>
+		bool get(T& value)
+		{
+			if (end - cursor < (std::ptrdiff_t)sizeof(T))
+				return false;
+			std::memcpy(&value, cursor, sizeof(T));
+			cursor += sizeof(T);
+			return true;
+		}
+
+		bool get_string(std::string& s)
+		{
+			uint32_t size;
+			if (!get(size) || end - cursor < (std::ptrdiff_t)size)
+				return false;
+			s.assign(cursor, size);
+			cursor += size;
+			return true;
+		}
+	};
+}
+
+SaveWriter::~SaveWriter()
+{
+	wait();
+}
+
+void SaveWriter::write_async(SavedGame save, const std::string& file_path)
+{
+	// Only one save is in flight at a time so an older save can't overwrite a newer one
+	wait();
+	m_Thread = std::thread([save = std::move(save), file_path]()
+	{
+		std::vector<char> bytes;
+		encode(save, bytes);
+		if (write_atomic(bytes, file_path))
+			printf("Saved to %s (%lu bytes)\n", file_path.c_str(), (unsigned long)bytes.size());
+		else
+			fprintf(stderr, "Failed to save to %s\n", file_path.c_str());
+	});
+}
+
+void SaveWriter::wait()
+{
+	if (m_Thread.joinable())
+		m_Thread.join();
+}
+
+void SaveWriter::encode(const SavedGame& save, std::vector<char>& out)
+{
+	out.insert(out.end(), std::begin(SAVE_MAGIC), std::end(SAVE_MAGIC));
+	put(out, SAVE_VERSION);
+
+	put_string(out, save.levelId);
+	put(out, (uint32_t)save.player);
+	put(out, (uint32_t)save.numPlayers);
+
+	put(out, (uint32_t)save.dialogueBoxes.size());
+	for (const auto& name : save.dialogueBoxes)
+		put_string(out, name);
+
+	put(out, (uint32_t)save.entities.size());
+	for (const auto& entity : save.entities)
+	{
+		uint8_t components = 0;
+		if (entity.turn) components |= SAVED_TURN;
+		if (entity.mass) components |= SAVED_MASS;
+		if (entity.sizeChangedTurnsRemaining) components |= SAVED_SIZE_CHANGED;
+		if (entity.massChangedTurnsRemaining) components |= SAVED_MASS_CHANGED;
+		if (entity.aiCountdown) components |= SAVED_AI;
+		if (entity.aiTarget) components |= SAVED_AI_TARGET;
+
+		put_string(out, entity.type);
+		put(out, components);
+
+		put(out, entity.motion.angle);
+		put(out, entity.motion.position);
+		put(out, entity.motion.velocity);
+		put(out, entity.motion.scale);
+		put(out, (uint8_t)entity.motion.can_move);
+
+		if (entity.turn)
+		{
+			put(out, (uint32_t)entity.turn->order);
+			put(out, (uint8_t)entity.turn->slung);
+			put(out, (int32_t)entity.turn->points);
+			put(out, entity.turn->countdown);
+		}
+		if (entity.mass) put(out, *entity.mass);
+		if (entity.sizeChangedTurnsRemaining) put(out, (int32_t)*entity.sizeChangedTurnsRemaining);
+		if (entity.massChangedTurnsRemaining) put(out, (int32_t)*entity.massChangedTurnsRemaining);
+		if (entity.aiCountdown) put(out, *entity.aiCountdown);
+		if (entity.aiTarget) put(out, *entity.aiTarget);
+	}
+}
+
+bool SaveWriter::write_atomic(const std::vector<char>& bytes, const std::string& file_path)
+{
+	namespace fs = std::filesystem;
+	std::error_code error;
+
+	fs::path path(file_path);
+	if (path.has_parent_path())
+		fs::create_directories(path.parent_path(), error);
+
+	fs::path temp_path = path;
+	temp_path += ".tmp";
+	{
+		std::ofstream fout(temp_path, std::ios::binary | std::ios::trunc);
+		fout.write(bytes.data(), bytes.size());
+		fout.flush();
+		if (!fout)
+			return false;
+	}
+
+	// Replacing the old save is a single rename, so it is either the old or the new file, never half of one
+	fs::rename(temp_path, path, error);
+	return !error;
+}
+
+std::optional<SavedGame> SaveWriter::read(const std::string& file_path)
+{
+	std::ifstream fin(file_path, std::ios::binary);
+	if (!fin)
+		return std::nullopt;
+	std::vector<char> bytes((std::istreambuf_iterator<char>(fin)), std::istreambuf_iterator<char>());
+
+	Reader in{ bytes.data(), bytes.data() + bytes.size() };
+	char magic[4];
+	uint16_t version;
+	if (!in.get(magic) || std::memcmp(magic, SAVE_MAGIC, sizeof(magic)) != 0 || !in.get(version) || version != SAVE_VERSION)
+		return std::nullopt;
+
+	SavedGame save;
+	uint32_t player, numPlayers, numDialogueBoxes, numEntities;
+	if (!in.get_string(save.levelId) || !in.get(player) || !in.get(numPlayers) || !in.get(numDialogueBoxes))
+		return std::nullopt;
+	save.player = player;
+	save.numPlayers = numPlayers;
+
+	save.dialogueBoxes.resize(numDialogueBoxes);
+	for (auto& name : save.dialogueBoxes)
+		if (!in.get_string(name))
+			return std::nullopt;
+
+	if (!in.get(numEntities))
+		return std::nullopt;
+	save.entities.resize(numEntities);
+	for (auto& entity : save.entities)
+	{
+		uint8_t components, can_move;
+		if (!in.get_string(entity.type) || !in.get(components))
+			return std::nullopt;
+		if (!in.get(entity.motion.angle) || !in.get(entity.motion.position) || !in.get(entity.motion.velocity)
+			|| !in.get(entity.motion.scale) || !in.get(can_move))
+			return std::nullopt;
+		entity.motion.can_move = can_move != 0;
+
+		if (components & SAVED_TURN)
+		{
+			uint32_t order;
+			uint8_t slung;
+			int32_t points;
+			Turn turn;
+			if (!in.get(order) || !in.get(slung) || !in.get(points) || !in.get(turn.countdown))
+				return std::nullopt;
+			turn.order = order;
+			turn.slung = slung != 0;
+			turn.points = points;
+			entity.turn = turn;
+		}
+		if (components & SAVED_MASS)
+		{
+			float mass;
+			if (!in.get(mass)) return std::nullopt;
+			entity.mass = mass;
+		}
+		if (components & SAVED_SIZE_CHANGED)
+		{
+			int32_t turnsRemaining;
+			if (!in.get(turnsRemaining)) return std::nullopt;
+			entity.sizeChangedTurnsRemaining = turnsRemaining;
+		}
+		if (components & SAVED_MASS_CHANGED)
+		{
+			int32_t turnsRemaining;
+			if (!in.get(turnsRemaining)) return std::nullopt;
+			entity.massChangedTurnsRemaining = turnsRemaining;
+		}
+		if (components & SAVED_AI)
+		{
+			float countdown;
+			if (!in.get(countdown)) return std::nullopt;
+			entity.aiCountdown = countdown;
+		}
+		if (components & SAVED_AI_TARGET)
+		{
+			vec2 target;
+			if (!in.get(target)) return std::nullopt;
+			entity.aiTarget = target;
+		}
+	}
+	return save;
+}
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "common.hpp"
+
+#include <optional>
+#include <string>
+#include <thread>
+#include <vector>
+
+// State of an entity that can change while a level is being played
+struct SavedEntity
+{
+	// Level map type key of the entity, e.g. "S0"
+	std::string type;
+
+	Motion motion;
+	std::optional<Turn> turn;
+	std::optional<float> mass;
+	std::optional<int> sizeChangedTurnsRemaining;
+	std::optional<int> massChangedTurnsRemaining;
+	std::optional<float> aiCountdown;
+	std::optional<vec2> aiTarget;
+};
+
+// A saved game only references its level file, since tiles never change while playing,
+// and stores the entities that differ from it (bros, enemies, power-ups and projectiles)
+struct SavedGame
+{
+	std::string levelId;
+	unsigned int player = 0;
+	size_t numPlayers = 0;
+	std::vector<std::string> dialogueBoxes;
+	std::vector<SavedEntity> entities;
+};
+
+// Writes saved games in a compact binary format on a background thread
+class SaveWriter
+{
+public:
+	~SaveWriter();
+
+	/**
+	 * Encodes and writes the saved game without blocking the caller.
+	 * The file is written next to its destination first and then renamed over it,
+	 * so a crash while saving never leaves a partially written save behind.
+	 *
+	 * @param save The saved game to write
+	 * @param file_path The path of the save file
+	 */
+	void write_async(SavedGame save, const std::string& file_path);
+
+	/**
+	 * Blocks until the pending save, if any, has been written
+	 */
+	void wait();
+
+	/**
+	 * Reads a saved game written by this class
+	 *
+	 * @param file_path The path of the save file
+	 * @return The saved game, or nothing if the file is missing or malformed
+	 */
+	static std::optional<SavedGame> read(const std::string& file_path);
+
+private:
+	static void encode(const SavedGame& save, std::vector<char>& out);
+
+	static bool write_atomic(const std::vector<char>& bytes, const std::string& file_path);
+
+	std::thread m_Thread;
+};
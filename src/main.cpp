@@ -4,6 +4,7 @@
 
 // stlib
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 
 // internal
@@ -12,9 +13,11 @@
 #include "render.hpp"
 #include "physics.hpp"
 #include "ai.hpp"
+#include "game_instance.hpp"
 #include "animation.hpp"
 #include "particle_system.hpp"
 #include "debug.hpp"
+#include "alloc_tracker.hpp"
 
 #include "Entity.h"
 #include "Camera.h"
@@ -38,24 +41,34 @@ int main()
 	// Initialize the main systems
 	WorldSystem world(WINDOW_SIZE_IN_PX);
 	RenderSystem renderer(*world.window);
-	PhysicsSystem physics;
+	GameInstance& game = WorldSystem::Game;
+	PhysicsSystem& physics = game.physics;
 	AnimationSystem animSystem;
 	ParticleSystem* particleSystem = ParticleSystem::GetInstance();
-	AISystem ai;
+
+	// The shown game presents what its rules report
+	game.particles = particleSystem;
+	game.events = [&world](GameEvent event, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
+		world.game_event_listener(event, entity_i, entity_j, hit_wall);
+	};
 
 	// Observer Pattern: attach collision listeners 
+	// Impact effects only happen once per impact rather than every step of a contact, like the rules
 	physics.attach([&world](ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
 		world.collision_listener(entity_i, entity_j, hit_wall);
-	});
+	}, CONTACT_BEGIN);
 	physics.attach([&animSystem](ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
 		animSystem.collision_listener(entity_i, entity_j, hit_wall);
-	});
+	}, CONTACT_BEGIN);
 	physics.attach([&particleSystem](ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
-		particleSystem->grass_collision_listener(entity_i, entity_j, hit_wall);
 		particleSystem->dirt_collision_listener(entity_i, entity_j, hit_wall);
 		particleSystem->lava_block_collision_listener(entity_i, entity_j, hit_wall);
 		particleSystem->beehive_collision_listener(entity_i, entity_j, hit_wall);
-	});
+	}, CONTACT_BEGIN);
+	// Grass leaves a trail of particles behind the bros moving through it
+	physics.attach([&particleSystem](ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall) {
+		particleSystem->grass_collision_listener(entity_i, entity_j, hit_wall);
+	}, CONTACT_BEGIN | CONTACT_STAY, GRASS_PARTICLE_INTERVAL_MS);
 
 	world.attach([&particleSystem](ECS_ENTT::Scene* scene) {
 		particleSystem->weather_listener(scene);
@@ -73,18 +86,60 @@ int main()
 	WorldSystem::FinaleInit();
 
 	auto freeze_time = DebugSystem::freeze_delay_ms;
-	// Variable timestep loop
+	// Simulates one fixed step, returns false if a new level was loaded during it
+	auto simulate = [&](float step_ms) {
+		DebugSystem::clearDebugComponents();
+		// Menus and help are scenes of their own, the game only moves while its scene is shown
+		game.scene = WorldSystem::ActiveScene;
+		{
+			AllocTracker::Scope scope(AllocTag::AI);
+			game.ai.step(game, step_ms, WINDOW_SIZE_IN_GAME_UNITS);
+		}
+		{
+			AllocTracker::Scope scope(AllocTag::World);
+			world.step(step_ms, WINDOW_SIZE_IN_GAME_UNITS);
+		}
+		{
+			AllocTracker::Scope scope(AllocTag::Particles);
+			particleSystem->step(step_ms);
+		}
+		if (world.getIsLoadNextLevel())
+		{
+			particleSystem->clearParticles();
+			world.load_next_level();
+			world.setIsLoadNextLevel(false);
+			return false;
+		}
+		game.scene = WorldSystem::ActiveScene;
+		{
+			AllocTracker::Scope scope(AllocTag::Physics);
+			physics.step(game, step_ms, WINDOW_SIZE_IN_GAME_UNITS);
+		}
+		{
+			AllocTracker::Scope scope(AllocTag::Animation);
+			animSystem.step(step_ms, WorldSystem::ActiveScene);
+		}
+		// Sync point, the entities destroyed during the step go away before anything is drawn
+		game.scene->m_Commands.flush(game.scene->m_Registry);
+		return true;
+	};
+
+	// Fixed timestep loop, real time and turbo mode take the exact same steps
+	float unsimulated_ms = 0.f;
 	while (!world.is_over())
 	{
+		AllocTracker::BeginFrame();
 		glEnable(GL_BLEND);
 		// Processes system messages, if this wasn't present the window would become unresponsive
 		glfwPollEvents();
 
 		// Calculating elapsed times in milliseconds from the previous iteration
 		auto now = Clock::now();
-		float elapsed_ms = min(30.f, static_cast<float>((std::chrono::duration_cast<std::chrono::microseconds>(now - time)).count()) / 1000.f);
+		float elapsed_ms = static_cast<float>((std::chrono::duration_cast<std::chrono::microseconds>(now - time)).count()) / 1000.f;
 		time = now;
 
+		// Input can load a level, which deletes the previous scene along with its camera
+		activeCamera = WorldSystem::GetActiveCamera();
 		world.HandleCameraMovement(activeCamera, elapsed_ms);
 
 		if (world.getIsLevelRestart()) {
@@ -93,20 +148,28 @@ int main()
 		}
 		
 		if (!DebugSystem::in_freeze_mode) {
-			DebugSystem::clearDebugComponents();
-			ai.step(elapsed_ms, WINDOW_SIZE_IN_GAME_UNITS);
-			world.step(elapsed_ms, WINDOW_SIZE_IN_GAME_UNITS);
-			activeCamera = WorldSystem::ActiveScene->GetCamera();
-			particleSystem->step(elapsed_ms);
-			if (world.getIsLoadNextLevel())
+			unsimulated_ms += elapsed_ms;
+			bool level_loaded = false;
+			for (int steps = 0; !level_loaded; steps++)
+			{
+				// Turbo mode ignores the wall clock until there is something for the player to do
+				if (WorldSystem::is_fast_forwarding()) {
+					if (steps == TURBO_STEPS_PER_FRAME)
+						break;
+				}
+				else if (unsimulated_ms < SIMULATION_STEP || steps >= MAX_STEPS_PER_FRAME)
+					break;
+
+				level_loaded = !simulate(SIMULATION_STEP);
+				unsimulated_ms = max(0.f, unsimulated_ms - SIMULATION_STEP);
+			}
+			// Drop the time a slow frame couldn't catch up on instead of spiralling
+			unsimulated_ms = min(unsimulated_ms, SIMULATION_STEP);
+			if (level_loaded)
 			{
-				particleSystem->clearParticles();
-				world.load_next_level();
-				world.setIsLoadNextLevel(false);
+				AllocTracker::EndFrame(false);
 				continue;
 			}
-			physics.step(elapsed_ms, WINDOW_SIZE_IN_GAME_UNITS);
-			animSystem.step(elapsed_ms, WorldSystem::ActiveScene);
 		}
 		else if (DebugSystem::in_freeze_mode)
 		{
@@ -116,7 +179,12 @@ int main()
 				freeze_time = DebugSystem::freeze_delay_ms;
 			}
 		}
-		renderer.draw(WINDOW_SIZE_IN_GAME_UNITS, *activeCamera, particleSystem);
+		activeCamera = WorldSystem::GetActiveCamera();
+		{
+			AllocTracker::Scope scope(AllocTag::Render);
+			renderer.draw(WINDOW_SIZE_IN_GAME_UNITS, *activeCamera, particleSystem);
+		}
+		AllocTracker::EndFrame(WorldSystem::is_settled());
 	}
 
 	return EXIT_SUCCESS;
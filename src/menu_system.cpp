@@ -68,7 +68,7 @@ void MenuSystem::set_main_menu(ECS_ENTT::Scene *scene, MainMenuType type)
 			vec2 quitButtonPos = vec2(MENU_CAMERA_POSITION.x, MENU_CAMERA_POSITION.y + 2.f * offset_y);
 
 			// Disable resume button if there is no saved file
-			const std::string saved_file_path = saved_path(yaml_file(SAVE_FILE_NAME));
+			const std::string saved_file_path = saved_path(save_file(SAVE_FILE_NAME));
 			auto button_name_resume = Util::file_exists(saved_file_path) ? BUTTON_NAME_RESUME : BUTTON_NAME_RESUME_DISABLED;
 
 			// Place the help, new, resume, and quit buttons on the screen
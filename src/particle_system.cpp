@@ -1,23 +1,18 @@
 #include "particle_system.hpp"
-#include "entities/windy_grass.hpp"
-#include "entities/lava_tile.hpp"
-#include "entities/ground_tile.hpp"
-#include "entities/grassy_tile.hpp"
 #include "entities/slingbro.hpp"
 #include "entities/speed_powerup.hpp"
 #include "entities/beehive_enemy.hpp"
 #include "render.hpp"
 #include "world.hpp"
+#include "loader/material_table.hpp"
 
+#include <algorithm>
 #include <glm/gtc/constants.hpp>
 #define GLM_ENABLE_EXPERIMENTAL
 #include <glm/gtx/compatibility.hpp>
 
 // Particle system structure based on example done by youtuber The Cherno in https://www.youtube.com/watch?v=GK0jHlv3e3w
 
-std::mt19937 Random::s_RandomEngine;
-std::uniform_int_distribution<std::mt19937::result_type> Random::s_Distribution(1, 100);
-
 ParticleSystem* ParticleSystem::instance = nullptr;
 
 const float WIND_MAGNITUDE = 0.005;
@@ -25,25 +20,21 @@ const float WIND_MAGNITUDE = 0.005;
 ParticleSystem::ParticleSystem(uint32_t maxNumParticles)
 	: m_PoolIndex(maxNumParticles - 1), m_ParticleMesh(nullptr), m_ParticleMeshInstanced(nullptr), m_BeeSwarms(std::vector<BeeSwarm*>())
 {
-	Random::Init();
 	m_ParticlePool.resize(maxNumParticles);
 	
-	std::string key = "particleSystemShadedMesh";
-	ShadedMesh* particleMesh = &cache_resource(key);
+	ShadedMesh* particleMesh = &cache_resource("particleSystemShadedMesh"_hs);
 
 	if (particleMesh->effect.program.resource == 0) {
 		RenderSystem::createParticle(*particleMesh, "particle_shader");
 	}
 
-	std::string keyInstanced = "particleSystemShadedMeshInstanced";
-	ShadedMesh* particleMeshInstanced = &cache_resource(keyInstanced);
+	ShadedMesh* particleMeshInstanced = &cache_resource("particleSystemShadedMeshInstanced"_hs);
 
 	if (particleMeshInstanced->effect.program.resource == 0) {
 		RenderSystem::createParticle(*particleMeshInstanced, "particle_shader_instanced");
 	}
 
-	std::string keyBeeMesh = "particleSystemBeeMesh";
-	ShadedMesh* beeMesh = &cache_resource(keyBeeMesh);
+	ShadedMesh* beeMesh = &cache_resource("particleSystemBeeMesh"_hs);
 
 	if (beeMesh->effect.program.resource == 0) {
 		RenderSystem::createBeeMesh(*beeMesh, "bee_shader");
@@ -72,6 +63,11 @@ uint32_t ParticleSystem::NumBeesTargetingEntity(uint32_t entityID)
 	return numBeestargetingEntity;
 }
 
+size_t ParticleSystem::NumBeeSwarms(const ECS_ENTT::Scene* scene) const
+{
+	return std::count_if(m_BeeSwarms.begin(), m_BeeSwarms.end(), [scene](const BeeSwarm* swarm) { return swarm->scene == scene; });
+}
+
 void ParticleSystem::step(float elapsed_ms) 
 {
 	for (auto& particle : m_ParticlePool)
@@ -128,7 +124,7 @@ void ParticleSystem::updateBeeProperties(Bee& bee, glm::vec3 swarmPosition)
 	if (glm::length(bee.offsetFromSwarmCenter) > 200.0f)
 	{
 		bee.velocity -= bee.offsetFromSwarmCenter / 2000.0f;
-		bee.velocity = bee.velocity + (glm::vec3((0.5f - Random::Float()), (0.5f - Random::Float()), (0.5f - Random::Float())));
+		bee.velocity = bee.velocity + (0.5f - glm::vec3(Random::Float(), Random::Float(), Random::Float()));
 	}
 	// Slow down bees that are very close to the center and going very fast
 	// This is to stop the hive from oscillating back and forth
@@ -139,14 +135,16 @@ void ParticleSystem::updateBeeProperties(Bee& bee, glm::vec3 swarmPosition)
 		bee.velocity *= 0.9f;
 	// Update bee positions
 	bee.position += bee.velocity;
-	// Add some randomness to the bee's velocity
-	bee.velocity = bee.velocity + (glm::vec3(0.5f - Random::Float(), 0.5f - Random::Float(), 0.5f - Random::Float())) / 5.0f;
+	// Add some randomness to the bee's velocity, drawing every number this bee needs at once
+	float noise[6];
+	Random::Fill(noise, 6);
+	bee.velocity = bee.velocity + (0.5f - glm::vec3(noise[0], noise[1], noise[2])) / 5.0f;
 	bee.velocity *= 0.995;
 
 	// Update bee rotations depending on movement pattern, with some randomness
-	bee.rotationX += bee.velocity.x * (0.5f - Random::Float()) / 2.0f;
-	bee.rotationY += bee.velocity.y * (0.5f - Random::Float()) / 2.0f;
-	bee.rotationZ += bee.velocity.z * (0.5f - Random::Float()) / 2.0f;
+	bee.rotationX += bee.velocity.x * (0.5f - noise[3]) / 2.0f;
+	bee.rotationY += bee.velocity.y * (0.5f - noise[4]) / 2.0f;
+	bee.rotationZ += bee.velocity.z * (0.5f - noise[5]) / 2.0f;
 }
 
 void ParticleSystem::Emit(const ParticleProperties& particleProps)
@@ -155,13 +153,16 @@ void ParticleSystem::Emit(const ParticleProperties& particleProps)
 	particle.active = true;
 	particle.affectedByWind = particleProps.affectedByWind;
 	particle.position = particleProps.position;
-	particle.rotation = Random::Float() * 2.0f * PI;
+
+	float noise[5];
+	Random::Fill(noise, 5);
+	particle.rotation = noise[0] * 2.0f * PI;
 
 	// Velocity
 	particle.velocity = particleProps.velocity;
-	particle.velocity.x += particleProps.velocityVariation.x * (Random::Float() - 0.5f);
-	particle.velocity.y += particleProps.velocityVariation.y * (Random::Float() - 0.5f);
-	particle.velocity.z += particleProps.velocityVariation.z * (Random::Float() - 0.5f);
+	particle.velocity.x += particleProps.velocityVariation.x * (noise[1] - 0.5f);
+	particle.velocity.y += particleProps.velocityVariation.y * (noise[2] - 0.5f);
+	particle.velocity.z += particleProps.velocityVariation.z * (noise[3] - 0.5f);
 
 	// Color
 	particle.colourBegin = particleProps.colourBegin;
@@ -170,7 +171,7 @@ void ParticleSystem::Emit(const ParticleProperties& particleProps)
 
 	particle.lifeTimeMs = particleProps.lifeTimeMs;
 	particle.lifeRemaining = particleProps.lifeTimeMs;
-	particle.sizeBegin = particleProps.sizeBegin + particleProps.sizeVariation * (Random::Float() - 0.5f);
+	particle.sizeBegin = particleProps.sizeBegin + particleProps.sizeVariation * (noise[4] - 0.5f);
 	particle.sizeEnd = particleProps.sizeEnd;
 	particle.currentSize = particle.sizeBegin;
 
@@ -179,18 +180,24 @@ void ParticleSystem::Emit(const ParticleProperties& particleProps)
 		m_PoolIndex = MAX_NUM_PARTICLES - 1;
 }
 
+// Particle effect of the material an entity is made of
+static ParticleEmitter emitter_of(ECS_ENTT::Entity entity)
+{
+	if (!entity.HasComponent<Material>())
+		return EMITTER_NONE;
+	return MaterialTable::get(entity.GetComponent<Material>().id).particles;
+}
+
 // Collisions between between bro and windy grass tiles - callback function, listening to PhysicsSystem::Collisions
 void ParticleSystem::grass_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall)
 {
 	if (!entity_i.IsValid() || !entity_j.IsValid())
 		return;
 
-	if (entity_j.HasComponent<WindyGrass>() && entity_i.HasComponent<SlingBro>())
+	if (emitter_of(entity_j) == EMITTER_GRASS && entity_i.HasComponent<SlingBro>())
 	{
 		Motion& grassMotionComponent = entity_j.GetComponent<Motion>();
 		Motion& slingBroMotionComponent = entity_i.GetComponent<Motion>();
-		if (WorldSystem::ActiveScene->m_Weather != WeatherTypes::Rain)
-			slingBroMotionComponent.velocity *= 0.99;
 
 		if (glm::length(slingBroMotionComponent.velocity) < 100.0f || grassMotionComponent.position.y >= slingBroMotionComponent.position.y + 20.0f)
 			return;
@@ -248,7 +255,7 @@ void ParticleSystem::dirt_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT
 	if (!entity_i.IsValid() || !entity_j.IsValid())
 		return;
 
-	if ((entity_j.HasComponent<GroundTile>() || entity_j.HasComponent<GrassyTile>()) && entity_i.HasComponent<SlingBro>())
+	if (emitter_of(entity_j) == EMITTER_DIRT && entity_i.HasComponent<SlingBro>())
 	{
 		Motion& slingBroMotionComponent = entity_i.GetComponent<Motion>();
 		Motion& tileMotionComponent = entity_j.GetComponent<Motion>();
@@ -325,32 +332,12 @@ void ParticleSystem::beehive_collision_listener(ECS_ENTT::Entity entity_i, ECS_E
 		auto& slingBroEntity = entity_i;
 		auto& beeHiveEntity = entity_j;
 
-		// Make the bees chase the player who hit their hive
+		// Make the bees chase the player who hit their hive, the honey is up to the GameplaySystem
 		BeeHiveEnemy& beeHiveComponent = beeHiveEntity.GetComponent<BeeHiveEnemy>();
-		BeeSwarm* collidedHivesBeeSwarm = beeHiveComponent.hiveSwarm;
-		collidedHivesBeeSwarm->isChasing = true;
-		collidedHivesBeeSwarm->targetedPlayerEntityID = slingBroEntity.GetEntityID();
-
-		// Give points for collecting honey from the hive
-		Turn& turnComponent = slingBroEntity.GetComponent<Turn>();
-		if (!beeHiveComponent.HasBeenHarvestedByPlayer(slingBroEntity.GetEntityID()))
+		if (BeeSwarm* collidedHivesBeeSwarm = beeHiveComponent.hiveSwarm)
 		{
-			turnComponent.points += POINTS_GAINED_HARVESTING_HONEY;
-			beeHiveComponent.harvestedByPlayers.push_back(slingBroEntity.GetEntityID());
-
-			// Emit some honey gloop particles
-			ParticleProperties particle;
-			particle.position = beeHiveEntity.GetComponent<Motion>().position;
-			particle.velocity = glm::vec3(0.0f, -0.05f, 0.0f);;
-			particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f);
-			particle.colourBegin = glm::vec4(250.0f / 255.0f, 189.0f / 255.0f, 42.0f / 255.0f, 1.0f);
-			particle.colourEnd = glm::vec4(200.0f / 255.0f, 139.0f / 255.0f, 0.0f / 255.0f, 0.2f);
-			particle.sizeBegin = 20.0f;
-			particle.sizeEnd = 2.0f;
-			particle.sizeVariation = 2.0f;
-			particle.lifeTimeMs = 4000.0f;
-			for (int i = 0; i < 100; i++)
-				Emit(particle);
+			collidedHivesBeeSwarm->isChasing = true;
+			collidedHivesBeeSwarm->targetedPlayerEntityID = slingBroEntity.GetEntityID();
 		}
 	}
 }
@@ -361,7 +348,7 @@ void ParticleSystem::lava_block_collision_listener(ECS_ENTT::Entity entity_i, EC
 	if (!entity_i.IsValid() || !entity_j.IsValid())
 		return;
 
-	if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<LavaTile>())
+	if (entity_i.HasComponent<SlingBro>() && emitter_of(entity_j) == EMITTER_LAVA)
 	{
 		Motion& slingBroMotionComponent = entity_i.GetComponent<Motion>();
 		Motion& lavaMotionComponent = entity_j.GetComponent<Motion>();
@@ -490,32 +477,33 @@ void ParticleSystem::clearParticles()
 	}
 }
 
-void ParticleSystem::clearBeeSwarms()
-{
-	for (BeeSwarm* swarm : m_BeeSwarms)
-		swarm->bees.clear();
-	m_BeeSwarms.clear();
-}
-
-std::vector<Particle> ParticleSystem::GetActiveParticles() const
+void ParticleSystem::clearBeeSwarms(ECS_ENTT::Scene* scene)
 {
-	std::vector<Particle> activeParticles;
-	for (const Particle& particle : m_ParticlePool)
-		if (particle.active)
-			activeParticles.push_back(particle);
-	return activeParticles;
+	// The memory goes back to the scene's entity pool for the swarms of a restarted level
+	auto first = std::remove_if(m_BeeSwarms.begin(), m_BeeSwarms.end(), [scene](BeeSwarm* swarm) {
+		if (swarm->scene != scene)
+			return false;
+		std::pmr::polymorphic_allocator<BeeSwarm> allocator(scene->GetEntityPool());
+		allocator.destroy(swarm);
+		allocator.deallocate(swarm, 1);
+		return true;
+	});
+	m_BeeSwarms.erase(first, m_BeeSwarms.end());
 }
 
-BeeSwarm* ParticleSystem::CreateBeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees)
+BeeSwarm* ParticleSystem::CreateBeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees, ECS_ENTT::Scene* scene)
 {
-	BeeSwarm* swarm = new BeeSwarm(swarmCenterPosition, numberOfBees);
+	std::pmr::polymorphic_allocator<BeeSwarm> allocator(scene->GetEntityPool());
+	BeeSwarm* swarm = allocator.allocate(1);
+	allocator.construct(swarm, swarmCenterPosition, numberOfBees, scene);
 	m_BeeSwarms.push_back(swarm);
 	return swarm;
 }
 
-BeeSwarm::BeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees)
-	: position(swarmCenterPosition), numBees(numberOfBees)
+BeeSwarm::BeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees, ECS_ENTT::Scene* scene)
+	: position(swarmCenterPosition), numBees(numberOfBees), bees(scene->GetEntityPool()), scene(scene)
 {
+	bees.reserve(numberOfBees);
 	// Initialize all the bees in the swarm with randomized starting positions, velocities, rotations
 	for (int i = 0; i < numBees; i++)
 	{
@@ -3,29 +3,11 @@
 #include "common.hpp"
 #include "render_components.hpp"
 #include "weather.hpp"
+#include "random.hpp"
 
-#include <random>
 
 // Particle system structure based on example done by youtuber The Cherno in https://www.youtube.com/watch?v=GK0jHlv3e3w
 
-class Random
-{
-public:
-	static void Init()
-	{
-		s_RandomEngine.seed(std::random_device()());
-	}
-
-	static float Float()
-	{
-		return (float)s_Distribution(s_RandomEngine) / 100.f;
-	}
-
-private:
-	static std::mt19937 s_RandomEngine;
-	static std::uniform_int_distribution<std::mt19937::result_type> s_Distribution;
-};
-
 struct ParticleProperties
 {
 	glm::vec3 position;
@@ -63,12 +45,13 @@ struct Bee
 	glm::vec4 colour = glm::vec4(1.0f, 1.0f, 0.0f, 1.0f); // default bee colour is yellow
 };
 
+// Allocated from the entity pool of its scene along with its bees
 struct BeeSwarm
 {
-	BeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees);
+	BeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees, ECS_ENTT::Scene* scene);
 	glm::vec3 position;
 	unsigned int numBees;
-	std::vector<Bee> bees;
+	std::pmr::vector<Bee> bees;
 
 	bool isChasing = false;
 	uint32_t targetedPlayerEntityID = -1;
@@ -91,10 +74,10 @@ public:
 
 	void weather_listener(ECS_ENTT::Scene* scene);
 
-	std::vector<Particle> GetParticles() const { return m_ParticlePool; }
-	std::vector<Particle> GetActiveParticles() const;
+	const std::vector<Particle>& GetParticles() const { return m_ParticlePool; }
 	void clearParticles();
-	void clearBeeSwarms();
+	// Destroys the swarms of a scene that is being unloaded
+	void clearBeeSwarms(ECS_ENTT::Scene* scene);
 	void updateBeeProperties(Bee& bee, glm::vec3 swarmPosition);
 
 	ShadedMesh* GetParticleMesh() const { return m_ParticleMesh; }
@@ -103,8 +86,9 @@ public:
 	ShadedMesh* GetBeeMesh() const { return m_BeeMesh; }
 	std::vector<BeeSwarm*>& GetBeeSwarms() { return m_BeeSwarms; }
 	
-	BeeSwarm* CreateBeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees);
+	BeeSwarm* CreateBeeSwarm(glm::vec3 swarmCenterPosition, unsigned int numberOfBees, ECS_ENTT::Scene* scene);
 	uint32_t NumBeesTargetingEntity(uint32_t entityID);
+	size_t NumBeeSwarms(const ECS_ENTT::Scene* scene) const;
 
 private:
 	ParticleSystem(uint32_t maxNumParticles);
@@ -3,11 +3,36 @@
 #include "physics.hpp"
 #include "debug.hpp"
 #include "world.hpp"
+#include "loader/material_table.hpp"
+#include <algorithm>
 #include <iostream>
+#include <limits>
 #include <entities/slingbro.hpp>
 
 static const float FRICTION = 0.1f;
 
+// Layers each layer collides with, pairs that no listener handles are left out so they are rejected
+// before any math. Tiles never move and triggers are only tested in the trigger pass. Enemies and
+// projectiles collide with bros so that they wake and hit the sleeping ones, which aren't tested.
+static const std::pair<uint16_t, uint16_t> layer_interactions[] = {
+		{ LAYER_BRO, LAYER_TILE | LAYER_BRO | LAYER_ENEMY | LAYER_PROJECTILE },
+		{ LAYER_ENEMY, LAYER_TILE | LAYER_BRO },
+		{ LAYER_SNAIL, LAYER_TILE },
+		{ LAYER_PROJECTILE, LAYER_TILE | LAYER_BRO },
+};
+
+// Layers of the bodies that move, bucketed into the broadphase grid every step
+static const uint16_t MOVING_LAYERS = LAYER_BRO | LAYER_ENEMY | LAYER_SNAIL | LAYER_PROJECTILE;
+
+static uint16_t get_collision_mask(uint16_t layer)
+{
+	uint16_t mask = LAYER_NONE;
+	for (const auto& [interacting_layer, interacting_mask] : layer_interactions)
+		if (layer & interacting_layer)
+			mask |= interacting_mask;
+	return mask;
+}
+
 // up down left right since rectangle only has 4 sides.
 static const vec2 directions[] = {
 		vec2(0.0f, 1.0f),
@@ -23,39 +48,37 @@ vec2 get_bounding_box(const Motion& motion)
 	return { abs(motion.scale.x), abs(motion.scale.y) };
 }
 
-// This is a SUPER APPROXIMATE check that puts a circle around the bounding boxes and sees
-// if the center point of either object is inside the other's bounding-box-circle. You don't
-// need to try to use this technique.
-bool collides(const Motion& motion1, const Motion& motion2)
+// Whether the entity of a body still takes part in the step, a collision callback may have
+// destroyed it or returned it to the projectile pool, which takes away its motion
+static bool is_alive(const entt::registry& registry, entt::entity entity)
 {
-	auto dp = motion1.position - motion2.position;
-	float dist_squared = dot(dp, dp);
-	float other_r = std::sqrt(std::pow(get_bounding_box(motion1).x / 2.0f, 2.f) + std::pow(get_bounding_box(motion1).y / 2.0f, 2.f));
-	float my_r = std::sqrt(std::pow(get_bounding_box(motion2).x / 2.0f, 2.f) + std::pow(get_bounding_box(motion2).y / 2.0f, 2.f));
-	float r = max(other_r, my_r);
-	return dist_squared < r * r;
+	return registry.valid(entity) && registry.has<Motion>(entity);
+}
+
+// Index of an entity regardless of its version, entities are numbered densely from 0
+static size_t entity_index(entt::entity entity)
+{
+	return entt::to_integral(entity) & entt::entt_traits<entt::entity>::entity_mask;
 }
 
-bool check_wall_collisions(Motion m)
+// Radius of the circle around the bounding box of an entity
+float get_bounding_radius(const Motion& motion)
 {
-	const float xpos = m.position.x;
-	const float ypos = m.position.y;
-	vec2 bounding_box = { abs(m.scale.x), abs(m.scale.y) };
-	float radius_i = sqrt(pow(bounding_box.x / 2.0f, 2.f)
-						  + pow(bounding_box.y / 2.0f, 2.f));
-	vec2 scene_size = WorldSystem::ActiveScene->m_Size;
-
-	return xpos - radius_i < 0.f || xpos + radius_i > scene_size.x || ypos - radius_i < 0.f ||
-		   ypos + radius_i > scene_size.y;
+	return 0.5f * glm::length(get_bounding_box(motion));
 }
 
-void reflect_and_add_friction_to_entity(float& velocity)
+// This is a SUPER APPROXIMATE check that puts a circle around the bounding boxes and sees
+// if the center point of either object is inside the other's bounding-box-circle. You don't
+// need to try to use this technique.
+bool collides(const Motion& motion1, const Motion& motion2, float radius1, float radius2)
 {
-	velocity *= -1;
-	velocity -= velocity * FRICTION;
+	auto dp = motion1.position - motion2.position;
+	float dist_squared = dot(dp, dp);
+	float r = max(radius1, radius2);
+	return dist_squared < r * r;
 }
 
-bool intersects(Motion circle, Motion rect)
+bool intersects(const Motion& circle, const Motion& rect)
 {
 	vec2 circleDistance;
 	circleDistance.x = abs(circle.position.x - rect.position.x);
@@ -127,126 +150,494 @@ vec2 circle_rect_distance(Motion& circle, Motion& rect, vec2 clamped)
 }
 
 
-void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
+void PhysicsSystem::PhysicsBodies::resize(size_t n)
 {
-	(void)window_size_in_game_units;
-
-	// Move entities based on how much time has passed, this is to (partially) avoid
-	// having entities move at different speed based on the machine.
-
-	auto motionEntitiesView = WorldSystem::ActiveScene->m_Registry.view<Motion>(); // position
+	entities.resize(n);
+	position_x.resize(n); position_y.resize(n); position_z.resize(n);
+	velocity_x.resize(n); velocity_y.resize(n); velocity_z.resize(n);
+	gravity.resize(n);
+	friction.resize(n);
+	can_move.resize(n);
+	radius.resize(n);
+	contacts.resize(n);
+	scale.resize(n, vec2(std::numeric_limits<float>::quiet_NaN()));
+	layer.resize(n);
+	mask.resize(n);
+	material.resize(n);
+	mass.resize(n);
+	flags.resize(n);
+}
 
-	// update positions for all entities
+void PhysicsSystem::sync_in(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	auto motionEntitiesView = registry.view<Motion>();
+	bodies.resize(motionEntitiesView.size());
+	entity_bodies.resize(registry.size());
+	kinematic_movers.clear();
+	colliding_bodies.clear();
+	trigger_bodies.clear();
+
+	float friction = scene->m_Weather == WeatherTypes::Rain
+					 ? RAIN_HORIZONTAL_FRICTION_MAGNITUDE
+					 : HORIZONTAL_FRICTION_MAGNITUDE;
+
+	size_t i = 0;
 	for (auto entityID : motionEntitiesView)
 	{
-		ECS_ENTT::Entity entity_i = ECS_ENTT::Entity(entityID, WorldSystem::ActiveScene);
-		auto& motionComponent_i = entity_i.GetComponent<Motion>();
+		const Motion& motion = motionEntitiesView.get<Motion>(entityID);
 
-		if (entity_i.HasComponent<Gravity>())
+		// Bodies stay in the same slots while no entity is created or destroyed, so the radius only
+		// has to be computed again when the slot changed hands or the entity was resized
+		if (bodies.entities[i] != entityID || bodies.scale[i] != vec2(motion.scale))
 		{
-			auto gravity = entity_i.GetComponent<Gravity>();
-			// gravity based on time passed
-			motionComponent_i.velocity.y += gravity.gravitational_constant * (elapsed_ms / 1000.0f);
-			// horizontal friction
-			auto friction = WorldSystem::ActiveScene->m_Weather == WeatherTypes::Rain
-							? RAIN_HORIZONTAL_FRICTION_MAGNITUDE
-							: HORIZONTAL_FRICTION_MAGNITUDE;
-			motionComponent_i.velocity.x -= motionComponent_i.velocity.x * (elapsed_ms / 1000.0f) * friction;
+			bodies.radius[i] = get_bounding_radius(motion);
+			bodies.scale[i] = vec2(motion.scale);
 		}
-
-		float step_seconds = 1.0f * (elapsed_ms / 1000.f);
-
-		// Move pathfinding AI
-		if (entity_i.HasComponent<AI>())
+		bodies.entities[i] = entityID;
+		entity_bodies[entity_index(entityID)] = uint32_t(i);
+
+		bodies.position_x[i] = motion.position.x;
+		bodies.position_y[i] = motion.position.y;
+		bodies.position_z[i] = motion.position.z;
+		bodies.velocity_x[i] = motion.velocity.x;
+		bodies.velocity_y[i] = motion.velocity.y;
+		bodies.velocity_z[i] = motion.velocity.z;
+		bodies.can_move[i] = motion.can_move ? 1.f : 0.f;
+		bodies.contacts[i] = 0;
+
+		const Gravity* gravity = registry.try_get<Gravity>(entityID);
+		bodies.gravity[i] = gravity ? gravity->gravitational_constant : 0.f;
+		bodies.friction[i] = gravity ? friction : 0.f;
+
+		uint8_t flags = 0;
+		if (!registry.has<IgnorePhysics>(entityID))
+			flags |= BODY_COLLIDES;
+
+		const Collider* collider = registry.try_get<Collider>(entityID);
+		bodies.layer[i] = collider ? collider->layer : LAYER_NONE;
+		bodies.mask[i] = bodies.layer[i] == LAYER_TRIGGER ? collider->activatedBy : get_collision_mask(bodies.layer[i]);
+
+		const Material* material = registry.try_get<Material>(entityID);
+		bodies.material[i] = material ? material->id : 0;
+
+		const Mass* mass = registry.try_get<Mass>(entityID);
+		bodies.mass[i] = mass ? mass->value : 1.f;
+
+		// Anything that gave a sleeping body a velocity or moved it, e.g. a sling or a knockback, wakes it up
+		if (Sleep* sleep = registry.try_get<Sleep>(entityID); sleep && sleep->asleep)
 		{
-			// Pathfinding AI have target node
-			auto ai = entity_i.GetComponent<AI>();
-			if (ai.target)
+			if (motion.velocity != vec3(0.f) || motion.position != sleep->position)
+				sleep->wake();
+			else
 			{
-				// Move AI min distance between expected step and target node destination
-				auto current_position = motionComponent_i.position;
-				auto next_position = current_position + motionComponent_i.velocity * step_seconds;
-				auto target = ai.target.value();
-				if (distance(current_position, next_position) > distance(vec2(current_position), target))
-				{
-					motionComponent_i.position = vec3(target, motionComponent_i.position.z);
-					motionComponent_i.can_move = false;
-				}
+				flags |= BODY_ASLEEP;
+				bodies.gravity[i] = 0.f;
+				bodies.can_move[i] = 0.f;
 			}
 		}
 
-		if (motionComponent_i.can_move)
+		if (bodies.layer[i] == LAYER_TRIGGER)
+			trigger_bodies.push_back(i);
+		else if ((flags & (BODY_COLLIDES | BODY_ASLEEP)) == BODY_COLLIDES && bodies.mask[i] != LAYER_NONE)
+		{
+			flags |= BODY_TESTED;
+			colliding_bodies.push_back(i);
+		}
+		bodies.flags[i] = flags;
+
+		// Kinematic bodies are left alone by the dynamic passes, their own pass moves them
+		if (registry.has<Kinematic>(entityID))
 		{
-			motionComponent_i.position += motionComponent_i.velocity * step_seconds;
+			const AI* ai = registry.try_get<AI>(entityID);
+			kinematic_movers.push_back({ i, motion.can_move, ai ? ai->target : std::nullopt });
+			bodies.gravity[i] = 0.f;
+			bodies.friction[i] = 0.f;
+			bodies.can_move[i] = 0.f;
 		}
+		i++;
 	}
+}
 
-	// check for collisions between all entities
-	for (auto entityID_i : motionEntitiesView)
+void PhysicsSystem::integrate(ECS_ENTT::Scene* scene, float step_seconds)
+{
+	(void)scene;
+	const size_t n = bodies.size();
+	float* vx = bodies.velocity_x.data();
+	float* vy = bodies.velocity_y.data();
+	const float* gravity = bodies.gravity.data();
+	const float* friction = bodies.friction.data();
+
+	// Gravity and horizontal friction, both are zero for bodies without gravity
+	for (size_t i = 0; i < n; i++)
 	{
-		ECS_ENTT::Entity entity_i = ECS_ENTT::Entity(entityID_i, WorldSystem::ActiveScene);
+		vy[i] += gravity[i] * step_seconds;
+		vx[i] -= vx[i] * step_seconds * friction[i];
+	}
 
-		// Disregard physics for all entities with the IgnorePhysics component (all tiles and purely visual entities)
-		if (entity_i.HasComponent<IgnorePhysics>()) 
+	float* px = bodies.position_x.data();
+	float* py = bodies.position_y.data();
+	float* pz = bodies.position_z.data();
+	const float* vz = bodies.velocity_z.data();
+	const float* can_move = bodies.can_move.data();
+	for (size_t i = 0; i < n; i++)
+	{
+		float step = step_seconds * can_move[i];
+		px[i] += vx[i] * step;
+		py[i] += vy[i] * step;
+		pz[i] += vz[i] * step;
+	}
+}
+
+void PhysicsSystem::move_kinematic(float step_seconds)
+{
+	for (const auto& mover : kinematic_movers)
+	{
+		if (!mover.can_move)
 			continue;
-		
-		auto& motionComponent_i = entity_i.GetComponent<Motion>();
 
-		// First check if the entity is colliding with any of the scene bounds
-		if (check_wall_collisions(motionComponent_i))
+		size_t i = mover.body;
+		vec2 position = { bodies.position_x[i], bodies.position_y[i] };
+		vec2 step = vec2(bodies.velocity_x[i], bodies.velocity_y[i]) * step_seconds;
+
+		// Pathfinding AI stop at their target node rather than overshooting it
+		if (mover.target && length(step) > distance(position, *mover.target))
 		{
-			const float x_pos = motionComponent_i.position.x;
-			const float y_pos = motionComponent_i.position.y;
-			vec2 bounding_box = { abs(motionComponent_i.scale.x), abs(motionComponent_i.scale.y) };
-			float radius_i = sqrt(pow(bounding_box.x / 2.0f, 2.f) + pow(bounding_box.y / 2.0f, 2.f));
+			bodies.position_x[i] = mover.target->x;
+			bodies.position_y[i] = mover.target->y;
+			continue;
+		}
+		bodies.position_x[i] += step.x;
+		bodies.position_y[i] += step.y;
+		bodies.position_z[i] += bodies.velocity_z[i] * step_seconds;
+	}
+}
 
-			vec2 size = WorldSystem::ActiveScene->m_Size;
+void PhysicsSystem::clamp_to_walls(vec2 scene_size)
+{
+	const size_t n = bodies.size();
+	float* px = bodies.position_x.data();
+	float* py = bodies.position_y.data();
+	float* vx = bodies.velocity_x.data();
+	float* vy = bodies.velocity_y.data();
+	const float* radius = bodies.radius.data();
+	const uint16_t* layer = bodies.layer.data();
+	uint8_t* flags = bodies.flags.data();
+	const float bounce = -(1.f - FRICTION);
+
+	// Only one wall is handled per step, checked in the order left, right, ceiling, floor
+	for (size_t i = 0; i < n; i++)
+	{
+		bool bounces = (flags[i] & (BODY_COLLIDES | BODY_ASLEEP)) == BODY_COLLIDES && !(layer[i] & LAYER_TILE);
+		float r = radius[i];
+		bool left = bounces && px[i] - r < 0.f;
+		bool right = bounces && !left && px[i] + r > scene_size.x;
+		bool ceiling = bounces && !left && !right && py[i] - r < 0.f;
+		bool floor = bounces && !left && !right && !ceiling && py[i] + r > scene_size.y;
+
+		px[i] = left ? r : (right ? scene_size.x - r : px[i]);
+		py[i] = ceiling ? r : (floor ? scene_size.y - r : py[i]);
+		vx[i] *= (left || right) ? bounce : 1.f;
+		vy[i] *= (ceiling || floor) ? bounce : 1.f;
+		flags[i] = (flags[i] & ~BODY_HIT_WALL) | ((left || right || ceiling || floor) ? BODY_HIT_WALL : 0);
+	}
+}
 
-			if (!entity_i.HasComponent<BouncyTile>())
-			{
-				if (x_pos - radius_i < 0.f) // left wall
-				{
-					motionComponent_i.position.x = 0.f + radius_i;
-					reflect_and_add_friction_to_entity(motionComponent_i.velocity.x);
-				}
-				else if (x_pos + radius_i > size.x) // right wall
-				{
-					motionComponent_i.position.x = size.x - radius_i;
-					reflect_and_add_friction_to_entity(motionComponent_i.velocity.x);
-				}
-				else if (y_pos - radius_i < 0.f) // ceiling
-				{
-					motionComponent_i.position.y = 0.f + radius_i;
-					reflect_and_add_friction_to_entity(motionComponent_i.velocity.y);
-				}
-				else if (y_pos + radius_i > size.y) // floor
-				{
-					motionComponent_i.position.y = size.y - radius_i;
-					reflect_and_add_friction_to_entity(motionComponent_i.velocity.y);
-				}
-				runCollisionCallbacks(entity_i, entity_i, true);
+void PhysicsSystem::sync_out(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		if (bodies.flags[i] & BODY_ASLEEP)
+			continue;
+		Motion& motion = registry.get<Motion>(bodies.entities[i]);
+		motion.position = { bodies.position_x[i], bodies.position_y[i], bodies.position_z[i] };
+		motion.velocity = { bodies.velocity_x[i], bodies.velocity_y[i], bodies.velocity_z[i] };
+	}
+}
+
+void PhysicsSystem::update_sleep(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		if ((bodies.flags[i] & BODY_ASLEEP) || !is_alive(registry, bodies.entities[i]))
+			continue;
+		Sleep* sleep = registry.try_get<Sleep>(bodies.entities[i]);
+		if (!sleep || sleep->asleep)
+			continue;
+
+		// A body is at rest while it is slow and supported by something, a body that is
+		// slow at the top of its arc doesn't count
+		Motion& motion = registry.get<Motion>(bodies.entities[i]);
+		sleep->ticksSinceContact = bodies.contacts[i] > 0 ? 0 : sleep->ticksSinceContact + 1;
+		bool at_rest = abs(motion.velocity.x) < SLEEP_VELOCITY && abs(motion.velocity.y) < SLEEP_VELOCITY
+					   && sleep->ticksSinceContact < SLEEP_CONTACT_TICKS;
+		sleep->restingTicks = at_rest ? sleep->restingTicks + 1 : 0;
+
+		if (sleep->restingTicks >= SLEEP_TICKS)
+		{
+			sleep->asleep = true;
+			sleep->position = motion.position;
+			motion.velocity = vec3(0.f);
+		}
+	}
+}
+
+void PhysicsSystem::wake(ECS_ENTT::Scene* scene, size_t body)
+{
+	if (!(bodies.flags[body] & BODY_ASLEEP))
+		return;
+	bodies.flags[body] &= ~BODY_ASLEEP;
+	scene->m_Registry.get<Sleep>(bodies.entities[body]).wake();
+}
+
+void PhysicsSystem::build_broadphase(vec2 scene_size)
+{
+	const size_t n = bodies.size();
+	float max_radius = 0.f;
+	for (size_t i = 0; i < n; i++)
+		if (bodies.layer[i] & MOVING_LAYERS)
+			max_radius = max(max_radius, bodies.radius[i]);
+
+	// Cells are large enough that a body only ever touches the bodies of the cells next to its own
+	BroadPhase& grid = broadphase;
+	grid.cell_size = max(2.f * max_radius, float(SPRITE_SCALE));
+	grid.num_cols = max(1, int(std::ceil(scene_size.x / grid.cell_size)));
+	grid.num_rows = max(1, int(std::ceil(scene_size.y / grid.cell_size)));
+
+	// Counting sort by cell, which keeps the bodies of a cell in body order
+	grid.cell_starts.assign(size_t(grid.num_cols * grid.num_rows) + 1, 0);
+	grid.body_cells.resize(n);
+	for (size_t i = 0; i < n; i++)
+	{
+		if (!(bodies.layer[i] & MOVING_LAYERS))
+		{
+			grid.body_cells[i] = std::numeric_limits<uint32_t>::max();
+			continue;
+		}
+		int col = std::clamp(int(std::floor(bodies.position_x[i] / grid.cell_size)), 0, grid.num_cols - 1);
+		int row = std::clamp(int(std::floor(bodies.position_y[i] / grid.cell_size)), 0, grid.num_rows - 1);
+		grid.body_cells[i] = uint32_t(row * grid.num_cols + col);
+		grid.cell_starts[grid.body_cells[i] + 1]++;
+	}
+	for (size_t c = 1; c < grid.cell_starts.size(); c++)
+		grid.cell_starts[c] += grid.cell_starts[c - 1];
+
+	grid.cursors.assign(grid.cell_starts.begin(), grid.cell_starts.end() - 1);
+	grid.cell_bodies.resize(grid.cell_starts.back());
+	for (size_t i = 0; i < n; i++)
+		if (grid.body_cells[i] != std::numeric_limits<uint32_t>::max())
+			grid.cell_bodies[grid.cursors[grid.body_cells[i]]++] = uint32_t(i);
+}
 
+void PhysicsSystem::query_broadphase(const ECS_ENTT::Scene* scene, vec2 position, float reach, bool with_tiles)
+{
+	candidates.clear();
+
+	const BroadPhase& grid = broadphase;
+	int first_col = std::clamp(int(std::floor((position.x - reach) / grid.cell_size)), 0, grid.num_cols - 1);
+	int last_col = std::clamp(int(std::floor((position.x + reach) / grid.cell_size)), 0, grid.num_cols - 1);
+	int first_row = std::clamp(int(std::floor((position.y - reach) / grid.cell_size)), 0, grid.num_rows - 1);
+	int last_row = std::clamp(int(std::floor((position.y + reach) / grid.cell_size)), 0, grid.num_rows - 1);
+	for (int row = first_row; row <= last_row; row++)
+	{
+		for (int col = first_col; col <= last_col; col++)
+		{
+			size_t cell = size_t(row * grid.num_cols + col);
+			for (uint32_t c = grid.cell_starts[cell]; c < grid.cell_starts[cell + 1]; c++)
+				candidates.push_back(grid.cell_bodies[c]);
+		}
+	}
+
+	// Tiles are centered on the cells of the level map
+	if (with_tiles)
+	{
+		const float tile_size = float(SPRITE_SCALE);
+		for (int row = int(std::floor((position.y - reach) / tile_size)); row <= int(std::ceil((position.y + reach) / tile_size)); row++)
+		{
+			for (int col = int(std::floor((position.x - reach) / tile_size)); col <= int(std::ceil((position.x + reach) / tile_size)); col++)
+			{
+				entt::entity tile = scene->GetTile(row, col);
+				if (tile == entt::null)
+					continue;
+				size_t body = entity_bodies[entity_index(tile)];
+				if (body < bodies.size() && bodies.entities[body] == tile)
+					candidates.push_back(body);
 			}
 		}
+	}
 
-		float radius = motionComponent_i.scale.x / 2;
+	// Same order as testing every body, so callbacks run in the same order
+	std::sort(candidates.begin(), candidates.end());
+}
+
+void PhysicsSystem::resolve_bro_collision(ECS_ENTT::Scene* scene, size_t body_1, size_t body_2)
+{
+	auto& registry = scene->m_Registry;
+	ECS_ENTT::Entity entity_1 = ECS_ENTT::Entity(bodies.entities[body_1], scene);
+	ECS_ENTT::Entity entity_2 = ECS_ENTT::Entity(bodies.entities[body_2], scene);
+	auto& motion_1 = entity_1.GetComponent<Motion>();
+	auto& motion_2 = entity_2.GetComponent<Motion>();
+	float mass_1 = bodies.mass[body_1];
+	float mass_2 = bodies.mass[body_2];
+
+	// Calculate bro radii
+	auto radius_1 = abs(motion_1.scale.x / 2.f);
+	auto radius_2 = abs(motion_2.scale.x / 2.f);
+
+	// Sum radii to get boundary between bro centers
+	auto collision_distance = radius_1 + radius_2; // Expected collision distance
+
+	// Calculate actual distance between the two bros
+	auto actual_distance = distance(vec2(motion_1.position), vec2(motion_2.position)); // Actual collision distance
+	if (actual_distance >= collision_distance)
+		return;
+
+	// Get x, y positions of the bros
+	auto x_1 = motion_1.position.x;
+	auto y_1 = motion_1.position.y;
+	auto x_2 = motion_2.position.x;
+	auto y_2 = motion_2.position.y;
+
+	// Compute x, y points of collision
+	auto collision_pt_x = (x_1 * radius_2 + x_2 * radius_1) / collision_distance;
+	auto collision_pt_y = (y_1 * radius_2 + y_2 * radius_1) / collision_distance;
+	auto collision_pt = vec2(collision_pt_x, collision_pt_y);
+
+	// Compute new velocities of the bros after elastic collision
+	auto mass_t = mass_1 + mass_2; // Total mass
+	glm::vec2 vel_1 = glm::vec2(motion_1.velocity);
+	glm::vec2 vel_2 = glm::vec2(motion_2.velocity);
+	glm::vec2 pos_1 = glm::vec2(motion_1.position);
+	glm::vec2 pos_2 = glm::vec2(motion_2.position);
+	glm::vec2 new_vel_1 = vel_1 - ((2 * mass_2 / mass_t) * glm::dot(vel_1 - vel_2, pos_1 - pos_2) / glm::length(pos_1 - pos_2) * (pos_1 - pos_2)) / 100.0f;
+	glm::vec2 new_vel_2 = vel_2 - ((2 * mass_1 / mass_t) * glm::dot(vel_2 - vel_1, pos_2 - pos_1) / glm::length(pos_2 - pos_1) * (pos_2 - pos_1)) / 100.0f;
+
+	// Calculate overlapping distance
+	auto overlap = abs(collision_distance - actual_distance) + 5.f; // Smol epsilon
+
+	// Compute the direction to move each object out
+	auto direction_1 = vec2(motion_1.position) - collision_pt; // Direction to move bro 1 out
+	auto direction_2 = vec2(motion_2.position) - collision_pt; // Direction to move bro 2 out
+
+	// Amount to move out each entity depends on mass ratio
+	// so lighter entities move out more so it visually makes sense
+	auto ratio_1 = mass_2 / mass_t; // Equivalent to 1 - m1/mt
+	auto ratio_2 = mass_1 / mass_t; // Equivalent to 1 - m2/mt
+	motion_1.position += vec3(overlap * ratio_1 * normalize(direction_1), 0.f);
+	motion_2.position += vec3(overlap * ratio_2 * normalize(direction_2), 0.f);
+
+	// Update bro velocity components
+	motion_1.velocity = { new_vel_1.x, new_vel_1.y, 0.f };
+	motion_2.velocity = { new_vel_2.x, new_vel_2.y, 0.f };
+
+	// Deform the characters, replacing any deformation still playing
+	glm::vec2 dispVec = vec2(motion_1.position) - vec2(motion_2.position);
+	float angle = atan(dispVec.y, dispVec.x); // angle in radians from one slingbro to the other
+	float squish_magnitude_1 = 0.5f + glm::length(new_vel_1) / MAX_VELOCITY;
+	float squish_magnitude_2 = 0.5f + glm::length(new_vel_2) / MAX_VELOCITY;
+	Deformation::start(scene, entity_1, 1.0f - (0.2f * squish_magnitude_1), 1.0f + (0.2f * squish_magnitude_1), angle, 100.0f);
+	Deformation::start(scene, entity_2, 1.0f - (0.2f * squish_magnitude_2), 1.0f + (0.2f * squish_magnitude_2), angle, 100.0f);
+
+	// A push from an awake bro wakes a sleeping one up
+	wake(scene, body_1);
+	wake(scene, body_2);
+	bodies.contacts[body_1]++;
+	bodies.contacts[body_2]++;
+
+	// Create a collision event for each of the bros - notify observers
+	runCollisionCallbacks(entity_1, entity_2, false);
+	if (registry.valid(entity_1) && registry.valid(entity_2))
+		runCollisionCallbacks(entity_2, entity_1, false);
+}
+
+void PhysicsSystem::step(GameInstance& game, float elapsed_ms, vec2 window_size_in_game_units)
+{
+	(void)window_size_in_game_units;
+	ECS_ENTT::Scene* scene = game.scene;
+	auto& registry = scene->m_Registry;
+
+	// Contacts refer to the entities of one scene, forget them when switching to another one
+	if (scene != contacts_scene)
+	{
+		contacts.clear();
+		contacts_scene = scene;
+	}
+	step_count++;
+	step_ms = elapsed_ms;
 
-		// Next check if any two entities are colliding
-		WorldSystem::ActiveScene->m_Registry.view<Motion>().each([&](const auto entityID_j, auto &&...)
+	// Move entities based on how much time has passed, this is to (partially) avoid
+	// having entities move at different speed based on the machine.
+	float step_seconds = 1.0f * (elapsed_ms / 1000.f);
+	sync_in(scene);
+	integrate(scene, step_seconds);
+	move_kinematic(step_seconds);
+
+	// First check if the entity is colliding with any of the scene bounds
+	clamp_to_walls(scene->m_Size);
+	sync_out(scene);
+	build_broadphase(scene->m_Size);
+
+	for (size_t i = 0; i < bodies.size(); i++)
+	{
+		if ((bodies.flags[i] & BODY_HIT_WALL) && is_alive(registry, bodies.entities[i]))
 		{
-			ECS_ENTT::Entity entity_j = ECS_ENTT::Entity(entityID_j, WorldSystem::ActiveScene);
+			ECS_ENTT::Entity entity_i = ECS_ENTT::Entity(bodies.entities[i], scene);
+			runCollisionCallbacks(entity_i, entity_i, true);
+		}
+	}
+
+	// check for collisions between all entities that collide with something. Entities with the IgnorePhysics
+	// component (all tiles and purely visual entities), sleeping bodies and triggers were left out by sync_in
+	for (size_t i : colliding_bodies)
+	{
+		// Skip those destroyed by a collision callback
+		if (!is_alive(registry, bodies.entities[i]))
+			continue;
+		const uint16_t mask_i = bodies.mask[i];
 
-			if (entity_j == entity_i) // Don't need to check if the same entity is colliding with each other
+		ECS_ENTT::Entity entity_i = ECS_ENTT::Entity(bodies.entities[i], scene);
+		const Motion& motion_i = entity_i.GetComponent<Motion>();
+		float radius = motion_i.scale.x / 2;
+
+		// Next check if any two entities are colliding. Only the bodies and tiles within a cell of the grid
+		// can touch the body, the margin covers the bodies that an earlier pair of the step pushed away.
+		query_broadphase(scene, vec2(motion_i.position), bodies.radius[i] + broadphase.cell_size, true);
+		for (size_t j : candidates)
+		{
+			if (j == i) // Don't need to check if the same entity is colliding with each other
+				continue;
+			// Reject pairs no listener handles before touching the registry
+			if ((bodies.layer[j] & mask_i) == 0 || !is_alive(registry, bodies.entities[j]))
+				continue;
+
+			// Awake bros test their pairs with enemies and projectiles themselves, the other
+			// side of such a pair only handles the bros that sleep
+			const bool hits_bro = (bodies.layer[j] & LAYER_BRO) && !(bodies.layer[i] & LAYER_BRO);
+			if (hits_bro && !(bodies.flags[j] & BODY_ASLEEP))
+				continue;
+
+			// Each pair of bros is resolved once, by the first of the two to be visited.
+			// Sleeping bros aren't visited, so the awake bro resolves their pairs.
+			if (bodies.layer[i] & bodies.layer[j] & LAYER_BRO)
 			{
-				return;
+				if (j > i || (bodies.flags[j] & BODY_ASLEEP))
+					resolve_bro_collision(scene, i, j);
+				if (!is_alive(registry, bodies.entities[i]))
+					break;
+				continue;
 			}
 
+			// Fetched for every pair since a callback that took away another entity's motion may have moved it
+			auto& motionComponent_i = entity_i.GetComponent<Motion>();
+			ECS_ENTT::Entity entity_j = ECS_ENTT::Entity(bodies.entities[j], scene);
 			auto& motionComponent_j = entity_j.GetComponent<Motion>();
 
 			//////////////////////////// Collision between a non-tile entity and a tile ////////////////////////////
 			// check for Tile BouncyTile and other Object Entity collisions
 			// for now, Tiles are stationary to simplify things
-			if (entity_j.HasComponent<BouncyTile>())
+			if (bodies.layer[j] & LAYER_TILE)
 			{
 				// entity_i is not a tile, entity_j is a tile.
 				// circle to rectangle collisions
@@ -254,11 +645,12 @@ void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 				vec2 collision = circle_rect_distance(motionComponent_i, motionComponent_j, clamped);
 				if (is_circle_rect_collision(collision, motionComponent_i))
 				{
+					// flip direction and keep the part of the velocity the tile's material gives back
+					const float bounce = -MaterialTable::get(bodies.material[j]).restitution;
 					VectorDir direction_i = vector_dir(glm::vec2(collision), clamped, motionComponent_i);
 					if (direction_i >= VectorDir::LEFT) // left or right - need to move position.x
 					{
-						// flip direction and multiply some friction
-						motionComponent_i.velocity.x *= VELOCITY_BOUNCE_MULTIPLIER;
+						motionComponent_i.velocity.x *= bounce;
 						float move_out_distance = radius - std::abs(collision.x);
 						if (direction_i == LEFT)
 						{
@@ -271,8 +663,7 @@ void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 					}
 					else if (direction_i <= VectorDir::DOWN) // up or down - need to move position.y
 					{
-						// flip direction and multiply some friction
-						motionComponent_i.velocity.y *= VELOCITY_BOUNCE_MULTIPLIER;
+						motionComponent_i.velocity.y *= bounce;
 						float move_out_distance = radius - std::abs(collision.y);
 						if (direction_i == UP)
 						{
@@ -283,142 +674,147 @@ void PhysicsSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 							motionComponent_i.position.y += move_out_distance;
 						}
 					}
+					bodies.contacts[i]++;
 					runCollisionCallbacks(entity_i, entity_j, true);
 				}
 			}
 			//////////////////////////////////////////////////////////////////////////////
 
 			// Check that the entities aren't both walls, and that they collide
-			if (!entity_j.HasComponent<BouncyTile>() && collides(motionComponent_i, motionComponent_j))
+			if (!(bodies.layer[j] & LAYER_TILE) && collides(motionComponent_i, motionComponent_j, bodies.radius[i], bodies.radius[j]))
 			{
-				// Create a collision event - notify observers
-				runCollisionCallbacks(entity_i, entity_j, false);
+				// Being hit wakes a sleeping body up
+				wake(scene, j);
+				bodies.contacts[i]++;
+
+				// Create a collision event - notify observers. Listeners expect the bro first.
+				if (hits_bro)
+					runCollisionCallbacks(entity_j, entity_i, false);
+				else
+					runCollisionCallbacks(entity_i, entity_j, false);
 			}
-		});
+
+			// A callback may have destroyed the entity this body belongs to
+			if (!is_alive(registry, bodies.entities[i]))
+				break;
+		}
 	}
 
-	// Handle bro-bro collision
-	auto slingbro_view = WorldSystem::ActiveScene->m_Registry.view<SlingBro>();
-	for (auto id_1 : slingbro_view)
+	// Triggers (power-ups, spikes, goals) don't push anything, they only need to know
+	// when a body of a layer that activates them overlaps them
+	const bool raining = scene->m_Weather == WeatherTypes::Rain;
+	for (size_t t : trigger_bodies)
 	{
-		// Retrieve the relevant components of the first bro
-		ECS_ENTT::Entity entity_1 = ECS_ENTT::Entity(id_1, WorldSystem::ActiveScene);
-		auto& motion_1 = entity_1.GetComponent<Motion>();
-		auto& mass_1 = entity_1.GetComponent<Mass>().value;
-
-		// Calculate bro radius
-		auto radius_1 = abs(motion_1.scale.x / 2.f);
-
-		// Get x, y positions and velocities of the first bro
-		auto x_1 = motion_1.position.x;
-		auto y_1 = motion_1.position.y;
-
-		// Handle bro-bro collision
-		for (auto id_2 : slingbro_view)
+		// Triggers made of a material, e.g. windy grass, slow down the bodies inside them
+		const MaterialProperties& material = MaterialTable::get(bodies.material[t]);
+		const float drag = raining ? material.rain_drag : material.drag;
+		vec2 position = { bodies.position_x[t], bodies.position_y[t] };
+		query_broadphase(scene, position, bodies.radius[t] + broadphase.cell_size, false);
+		for (size_t i : candidates)
 		{
-			// Skip collision check with same entity
-			if (id_1 == id_2) continue;
-
-			// Retrieve the relevant components of the bros
-			ECS_ENTT::Entity entity_2 = ECS_ENTT::Entity(id_2, WorldSystem::ActiveScene);
-			auto& motion_2 = entity_2.GetComponent<Motion>();
-			auto& mass_2 = entity_2.GetComponent<Mass>().value;
-
-			// Calculate bro radius
-			auto radius_2 = abs(motion_2.scale.x / 2.f);
-
-			// Sum radii to get boundary between bro centers
-			auto collision_distance = radius_1 + radius_2; // Expected collision distance
-
-			// Calculate actual distance between the two bros
-			auto actual_distance = distance(vec2(motion_1.position), vec2(motion_2.position)); // Actual collision distance
-
-			// Bros collide
-			if (actual_distance < collision_distance)
+			if (!(bodies.flags[i] & BODY_TESTED) || (bodies.layer[i] & bodies.mask[t]) == 0)
+				continue;
+			// A callback may have destroyed either entity
+			if (!is_alive(registry, bodies.entities[t]))
+				break;
+			if (!is_alive(registry, bodies.entities[i]))
+				continue;
+
+			ECS_ENTT::Entity entity_i = ECS_ENTT::Entity(bodies.entities[i], scene);
+			ECS_ENTT::Entity trigger = ECS_ENTT::Entity(bodies.entities[t], scene);
+			Motion& motion_i = entity_i.GetComponent<Motion>();
+			if (collides(motion_i, trigger.GetComponent<Motion>(), bodies.radius[i], bodies.radius[t]))
 			{
-				// Get x, y positions and velocities of the second bro
-				auto x_2 = motion_2.position.x;
-				auto y_2 = motion_2.position.y;
-
-				// Compute x, y points of collision
-				auto collision_pt_x = (x_1 * radius_2 + x_2 * radius_1) / collision_distance;
-				auto collision_pt_y = (y_1 * radius_2 + y_2 * radius_1) / collision_distance;
-				auto collision_pt = vec2(collision_pt_x, collision_pt_y);
-
-				// Compute new velocities of the bros after elastic collision
-				auto mass_t = mass_1 + mass_2; // Total mass
-				glm::vec2 vel_1 = glm::vec2(motion_1.velocity);
-				glm::vec2 vel_2 = glm::vec2(motion_2.velocity); 
-				glm::vec2 pos_1 = glm::vec2(motion_1.position);
-				glm::vec2 pos_2 = glm::vec2(motion_2.position);
-				glm::vec2 new_vel_1 = vel_1 - ((2 * mass_2 / mass_t) * glm::dot(vel_1 - vel_2, pos_1 - pos_2) / glm::length(pos_1 - pos_2) * (pos_1 - pos_2)) / 100.0f;
-				glm::vec2 new_vel_2 = vel_2 - ((2 * mass_1 / mass_t) * glm::dot(vel_2 - vel_1, pos_2 - pos_1) / glm::length(pos_2 - pos_1) * (pos_2 - pos_1)) / 100.0f;
-
-				// Calculate overlapping distance
-				auto overlap = abs(collision_distance - actual_distance) + 5.f; // Smol epsilon
-
-				// Compute the direction to move each object out
-				auto direction_1 = vec2(motion_1.position) - collision_pt; // Direction to move bro 1 out
-				auto direction_2 = vec2(motion_2.position) - collision_pt; // Direction to move bro 2 out
-
-				// Amount to move out each entity depends on mass ratio
-				// so lighter entities move out more so it visually makes sense
-				auto ratio_1 = mass_2 / mass_t; // Equivalent to 1 - m1/mt
-				auto ratio_2 = mass_1 / mass_t; // Equivalent to 1 - m2/mt
-				motion_1.position += vec3(overlap * ratio_1 * normalize(direction_1), 0.f);
-				motion_2.position += vec3(overlap * ratio_2 * normalize(direction_2), 0.f);
-
-				// Update bro velocity components
-				motion_1.velocity = { new_vel_1.x, new_vel_1.y, 0.f };
-				motion_2.velocity = { new_vel_2.x, new_vel_2.y, 0.f };
-
-				// Deform the characters
-				glm::vec2 dispVec = vec2(motion_1.position) - vec2(motion_2.position);
-				float angle = atan(dispVec.y, dispVec.x); // angle in radians from one slingbro to the other
-				if (entity_1.HasComponent<Deformation>())
-					entity_1.RemoveComponent<Deformation>();
-				if (entity_2.HasComponent<Deformation>())
-					entity_2.RemoveComponent<Deformation>();
-				float squish_magnitude_1 = 0.5f + glm::length(new_vel_1) / MAX_VELOCITY;
-				float squish_magnitude_2 = 0.5f + glm::length(new_vel_2) / MAX_VELOCITY;
-				entity_1.AddComponent<Deformation>(1.0f - (0.2f * squish_magnitude_1), 1.0f + (0.2f * squish_magnitude_1), angle, 100.0f);
-				entity_2.AddComponent<Deformation>(1.0f - (0.2f * squish_magnitude_2), 1.0f + (0.2f * squish_magnitude_2), angle, 100.0f);
-
-				// Create a collision event - notify observers
-				runCollisionCallbacks(entity_1, entity_2, false);
+				motion_i.velocity *= drag;
+				runCollisionCallbacks(entity_i, trigger, false);
 			}
 		}
 	}
 
-	// Visualization for debugging the position and scale of objects
-	if (DebugSystem::in_debug_mode)
-	{
-		for (auto& entityID : motionEntitiesView)
-		{
-			ECS_ENTT::Entity entity = ECS_ENTT::Entity(entityID, WorldSystem::ActiveScene);
-			auto& m = entity.GetComponent<Motion>();
+	update_sleep(scene);
+	end_stale_contacts(scene);
 
-			if (entity.HasComponent<Tile>()) {
-				DebugSystem::createBox(m.position, get_bounding_box(m), m.scale);
-			}
-			else {
-				DebugSystem::createCircle(m.position, m.scale);
-			}
-		}
+	// Visualization for debugging the position and scale of objects, only for the game on screen
+	if (DebugSystem::in_debug_mode && scene == WorldSystem::ActiveScene)
+	{
+		registry.view<Motion, Tile>().each([](const Motion& m, const Tile&) {
+			DebugSystem::createBox(m.position, get_bounding_box(m), m.scale);
+		});
+		registry.view<Motion>(entt::exclude<Tile>).each([](const Motion& m) {
+			DebugSystem::createCircle(m.position, m.scale);
+		});
 	}
 }
 
-void PhysicsSystem::attach(std::function<void(ECS_ENTT::Entity, ECS_ENTT::Entity, bool)> fn)
+void PhysicsSystem::attach(CollisionCallback fn, uint8_t phases, float stay_interval_ms)
 {
-	callbacks.push_back(fn);
+	callbacks.push_back({ std::move(fn), phases, stay_interval_ms });
+}
+
+uint64_t PhysicsSystem::contact_key(entt::entity i, entt::entity j)
+{
+	return (uint64_t(entt::to_integral(i)) << 32) | uint64_t(entt::to_integral(j));
 }
 
 // this should be called after collision detected
 void PhysicsSystem::runCollisionCallbacks(ECS_ENTT::Entity i, ECS_ENTT::Entity j, bool hit_wall)
 {
-	for (std::function<void(ECS_ENTT::Entity, ECS_ENTT::Entity, bool)> fn : callbacks)
+	auto [it, began] = contacts.try_emplace(contact_key(i, j));
+	Contact& contact = it->second;
+
+	// A pair can be reported more than once per step, e.g. by both the pair checks and the bro-bro response
+	if (!began && contact.last_step == step_count)
+		return;
+
+	// Contacts are rediscovered every step, so only the first step of a contact is a new impact
+	float previous_stay_ms = contact.stay_ms;
+	bool stayed = !began;
+	if (stayed)
+		contact.stay_ms += step_ms;
+	contact.last_step = step_count;
+	contact.hit_wall = hit_wall;
+
+	for (const auto& listener : callbacks)
 	{
-		// run the callback functions
-		fn(i, j, hit_wall);
+		if (began && (listener.phases & CONTACT_BEGIN))
+			listener.fn(i, j, hit_wall);
+		else if (stayed && (listener.phases & CONTACT_STAY))
+		{
+			// Throttled listeners are called each time the contact crosses another multiple of their interval
+			if (listener.stay_interval_ms <= 0.f
+				|| std::floor(contact.stay_ms / listener.stay_interval_ms) != std::floor(previous_stay_ms / listener.stay_interval_ms))
+				listener.fn(i, j, hit_wall);
+		}
+	}
+}
+
+void PhysicsSystem::end_stale_contacts(ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	for (auto it = contacts.begin(); it != contacts.end();)
+	{
+		entt::entity entity_i = entt::entity(uint32_t(it->first >> 32));
+		entt::entity entity_j = entt::entity(uint32_t(it->first));
+		Contact& contact = it->second;
+
+		// Sleeping bodies aren't checked for collisions, but keep resting on whatever they touch
+		bool valid = registry.valid(entity_i) && registry.valid(entity_j);
+		if (valid && registry.has<Sleep>(entity_i) && registry.get<Sleep>(entity_i).asleep)
+			contact.last_step = step_count;
+
+		// Resting bodies alternate between touching and being pushed clear, so a contact only ends after a few steps apart
+		if (valid && step_count - contact.last_step < CONTACT_END_STEPS)
+		{
+			++it;
+			continue;
+		}
+
+		bool hit_wall = contact.hit_wall;
+		it = contacts.erase(it);
+		for (const auto& listener : callbacks)
+		{
+			if (listener.phases & CONTACT_END)
+				listener.fn({ entity_i, scene }, { entity_j, scene }, hit_wall);
+		}
 	}
 }
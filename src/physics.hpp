@@ -2,18 +2,168 @@
 
 #include "common.hpp"
 #include "Entity.h"
+#include "Scene.h"
+
+#include <optional>
+#include <unordered_map>
+
+struct GameInstance;
+
+// Phases of a contact between two entities that collision listeners can subscribe to
+enum ContactPhase : uint8_t
+{
+	CONTACT_BEGIN = 1 << 0,	// First step the entities touch
+	CONTACT_STAY = 1 << 1,	// Every following step they keep touching
+	CONTACT_END = 1 << 2	// The entities stopped touching, either of them may have been destroyed
+};
 
 // A simple physics system that moves rigid bodies and checks for collision
 class PhysicsSystem
 {
 public:
-	std::vector<std::function<void(ECS_ENTT::Entity, ECS_ENTT::Entity, bool)>> callbacks;
+	using CollisionCallback = std::function<void(ECS_ENTT::Entity, ECS_ENTT::Entity, bool)>;
 
-	void step(float elapsed_ms, vec2 window_size_in_game_units);
+	void step(GameInstance& game, float elapsed_ms, vec2 window_size_in_game_units);
 
-	void attach(std::function<void(ECS_ENTT::Entity, ECS_ENTT::Entity, bool)>);
+	/**
+	 * Subscribes a listener to collisions
+	 *
+	 * @param fn The listener, called with the two entities and whether the first one hit a wall or tile
+	 * @param phases The ContactPhase flags the listener is called for
+	 * @param stay_interval_ms Minimum time between two calls for the same ongoing contact, 0 to be called every step
+	 */
+	void attach(CollisionCallback fn, uint8_t phases = CONTACT_BEGIN | CONTACT_STAY, float stay_interval_ms = 0.f);
 
+	// Records that two entities touch during the current step, notifying the listeners of the contact's phase
 	void runCollisionCallbacks(ECS_ENTT::Entity i, ECS_ENTT::Entity j, bool hit_wall);
+
+private:
+	struct CollisionListener
+	{
+		CollisionCallback fn;
+		uint8_t phases;
+		float stay_interval_ms;
+	};
+
+	// An ongoing contact, keyed by the pair of entities in the order they were reported
+	struct Contact
+	{
+		bool hit_wall = false;
+		uint32_t last_step = 0;	// Last step the entities touched
+		float stay_ms = 0.f;		// Time since the contact began
+	};
+
+	static uint64_t contact_key(entt::entity i, entt::entity j);
+
+	// Ends the contacts that weren't reported for a few steps
+	void end_stale_contacts(ECS_ENTT::Scene* scene);
+
+	std::vector<CollisionListener> callbacks;
+
+	std::unordered_map<uint64_t, Contact> contacts;
+	ECS_ENTT::Scene* contacts_scene = nullptr;
+	uint32_t step_count = 0;
+	float step_ms = 0.f;
+
+	// Packed copy of the motion of every entity, stored as a structure of arrays in registry order.
+	// Integration and wall clamping run as straight passes over these contiguous floats, which the
+	// compiler can vectorise, and the results are written back to the Motion components afterwards.
+	struct PhysicsBodies
+	{
+		std::vector<entt::entity> entities;
+		std::vector<float> position_x, position_y, position_z;
+		std::vector<float> velocity_x, velocity_y, velocity_z;
+		std::vector<float> gravity;		// Gravitational constant, 0 for bodies without gravity
+		std::vector<float> friction;	// Horizontal friction, 0 for bodies without gravity
+		std::vector<float> can_move;	// 1 if the body moves with its velocity, 0 otherwise
+		std::vector<float> radius;		// Radius of the circle around the bounding box
+		std::vector<int> contacts;		// Tiles touched during the current step
+		std::vector<vec2> scale;		// Scale the radius was last computed for
+		std::vector<uint16_t> layer;	// CollisionLayer of the body
+		std::vector<uint16_t> mask;		// Layers the body collides with, or that activate it for triggers
+		std::vector<uint8_t> material;	// Index into the MaterialTable, 0 for bodies without a material
+		std::vector<float> mass;		// 1 for bodies without a Mass
+		std::vector<uint8_t> flags;
+
+		size_t size() const { return entities.size(); }
+		void resize(size_t n);
+	};
+
+	enum BodyFlags : uint8_t
+	{
+		BODY_COLLIDES = 1 << 0,		// Not ignored by the physics system
+		BODY_TESTED = 1 << 1,		// In colliding_bodies, i.e. awake and colliding with some layer
+		BODY_HIT_WALL = 1 << 2,		// Set by the wall pass of the current step
+		BODY_ASLEEP = 1 << 3
+	};
+
+	// Copies the registry's motion into the packed bodies, recomputing radii only for bodies whose scale changed
+	void sync_in(ECS_ENTT::Scene* scene);
+
+	void integrate(ECS_ENTT::Scene* scene, float step_seconds);
+
+	// Moves the kinematic bodies along their velocity, stopping at their AI's waypoint
+	void move_kinematic(float step_seconds);
+
+	// Pushes bodies that left the scene back inside of it and bounces them off the wall
+	void clamp_to_walls(vec2 scene_size);
+
+	void sync_out(ECS_ENTT::Scene* scene);
+
+	// Elastic collision between two overlapping bros, pushing them apart by their mass ratio
+	void resolve_bro_collision(ECS_ENTT::Scene* scene, size_t body_1, size_t body_2);
+
+	// Puts bodies that stayed at rest long enough to sleep
+	void update_sleep(ECS_ENTT::Scene* scene);
+
+	// Wakes a sleeping body that was touched by an awake one
+	void wake(ECS_ENTT::Scene* scene, size_t body);
+
+	// Buckets the bodies that aren't tiles or triggers into the broadphase grid at their current position
+	void build_broadphase(vec2 scene_size);
+
+	/**
+	 * Collects the candidates of a body's pair tests into `candidates`, sorted in body order
+	 *
+	 * @param scene The scene whose tile grid holds the tiles
+	 * @param position The position of the body
+	 * @param reach Distance from the position that bodies and tiles are collected within
+	 * @param with_tiles Whether to collect tiles along with the bodies of the grid
+	 */
+	void query_broadphase(const ECS_ENTT::Scene* scene, vec2 position, float reach, bool with_tiles);
+
+	PhysicsBodies bodies;
+
+	// Bodies that collide with at least one layer, and trigger volumes, rebuilt by sync_in
+	std::vector<size_t> colliding_bodies;
+	std::vector<size_t> trigger_bodies;
+
+	// Body of each entity index, to find the bodies of the tiles in the scene's tile grid
+	std::vector<uint32_t> entity_bodies;
+
+	// Uniform grid over the bodies that move, i.e. those that aren't tiles or triggers, rebuilt every step
+	// so that a body is only tested against its neighbours. Tiles never move, the scene's tile grid finds them.
+	struct BroadPhase
+	{
+		float cell_size = 0.f;		// Twice the largest radius in the grid, and at least a tile
+		int num_cols = 0;
+		int num_rows = 0;
+		std::vector<uint32_t> cell_starts;	// The bodies of cell c are cell_bodies[cell_starts[c], cell_starts[c + 1])
+		std::vector<uint32_t> cell_bodies;
+		std::vector<uint32_t> cursors;		// Insertion points while bucketing
+		std::vector<uint32_t> body_cells;	// Cell of each body in the grid while bucketing
+	};
+	BroadPhase broadphase;
+	std::vector<size_t> candidates;
+
+	// Bodies moved by their AI, kept out of the dynamic passes
+	struct KinematicMover
+	{
+		size_t body;
+		bool can_move;
+		std::optional<vec2> target;	// Waypoint the mover stops at rather than overshooting it
+	};
+	std::vector<KinematicMover> kinematic_movers;
 };
 
 enum VectorDir
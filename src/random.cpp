@@ -0,0 +1,109 @@
+#include "random.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+
+namespace
+{
+	uint32_t rotl(uint32_t x, int k)
+	{
+		return (x << k) | (x >> (32 - k));
+	}
+
+	// Spreads a seed over the whole state, xoshiro must not start from all zeros
+	uint64_t splitmix64(uint64_t& x)
+	{
+		uint64_t z = (x += 0x9e3779b97f4a7c15ull);
+		z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ull;
+		z = (z ^ (z >> 27)) * 0x94d049bb133111ebull;
+		return z ^ (z >> 31);
+	}
+}
+
+uint64_t Random::s_MasterSeed = 0;
+RandomStream Random::s_Streams;
+RandomStream Random::s_MainStream;
+std::mutex Random::s_StreamsMutex;
+
+RandomStream::RandomStream(uint64_t seed)
+{
+	uint64_t a = splitmix64(seed);
+	uint64_t b = splitmix64(seed);
+	m_State[0] = (uint32_t)a;
+	m_State[1] = (uint32_t)(a >> 32);
+	m_State[2] = (uint32_t)b;
+	m_State[3] = (uint32_t)(b >> 32);
+}
+
+uint32_t RandomStream::UInt()
+{
+	const uint32_t result = m_State[0] + m_State[3];
+	const uint32_t t = m_State[1] << 9;
+
+	m_State[2] ^= m_State[0];
+	m_State[3] ^= m_State[1];
+	m_State[1] ^= m_State[2];
+	m_State[0] ^= m_State[3];
+	m_State[2] ^= t;
+	m_State[3] = rotl(m_State[3], 11);
+
+	return result;
+}
+
+void RandomStream::Fill(float* out, size_t count)
+{
+	for (size_t i = 0; i < count; i++)
+		out[i] = Float();
+}
+
+RandomStream RandomStream::Split()
+{
+	RandomStream stream = *this;
+	Jump();
+	return stream;
+}
+
+void RandomStream::Jump()
+{
+	static const uint32_t JUMP[] = { 0x8764000b, 0xf542d2d3, 0x6fa035c3, 0x77f2db5b };
+
+	uint32_t s[4] = { 0, 0, 0, 0 };
+	for (uint32_t jump : JUMP)
+	{
+		for (int b = 0; b < 32; b++)
+		{
+			if (jump & (1u << b))
+			{
+				for (int i = 0; i < 4; i++)
+					s[i] ^= m_State[i];
+			}
+			UInt();
+		}
+	}
+	for (int i = 0; i < 4; i++)
+		m_State[i] = s[i];
+}
+
+void Random::Init()
+{
+	if (const char* seed = std::getenv("SLINGBROS_SEED"))
+		Init(std::strtoull(seed, nullptr, 10));
+	else
+		Init(((uint64_t)std::random_device()() << 32) | std::random_device()());
+}
+
+void Random::Init(uint64_t masterSeed)
+{
+	std::lock_guard<std::mutex> lock(s_StreamsMutex);
+	s_MasterSeed = masterSeed;
+	s_Streams = RandomStream(masterSeed);
+	s_MainStream = s_Streams.Split();
+	printf("Random seed: %llu\n", (unsigned long long)masterSeed);
+}
+
+RandomStream Random::Stream()
+{
+	std::lock_guard<std::mutex> lock(s_StreamsMutex);
+	return s_Streams.Split();
+}
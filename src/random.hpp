@@ -0,0 +1,66 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+
+// xoshiro128+ generator, see https://prng.di.unimi.it/. It is a handful of adds, xors and shifts
+// per number, and jumping ahead splits it into streams that never overlap.
+class RandomStream
+{
+public:
+	explicit RandomStream(uint64_t seed = 0);
+
+	uint32_t UInt();
+
+	// Uniform in [0, 1) with 24 bits of resolution
+	float Float()
+	{
+		return (float)(UInt() >> 8) * (1.f / 16777216.f);
+	}
+
+	// Fills a buffer with Float()s, for loops that need several numbers per element
+	void Fill(float* out, size_t count);
+
+	// Advances this stream by 2^64 numbers and returns a stream starting where it was
+	RandomStream Split();
+
+private:
+	void Jump();
+
+	uint32_t m_State[4];
+};
+
+// Every stream of a session is split from one master seed, so a session can be replayed by passing
+// its seed, which is printed at startup, through the SLINGBROS_SEED environment variable
+class Random
+{
+public:
+	// Seeds the session from SLINGBROS_SEED if it is set, or from the random device otherwise
+	static void Init();
+
+	static void Init(uint64_t masterSeed);
+
+	static uint64_t MasterSeed() { return s_MasterSeed; }
+
+	// A new stream for a system or thread of its own. Safe to call from any thread.
+	static RandomStream Stream();
+
+	// Draws from the main thread's stream, only for cosmetic effects such as particles. Anything that
+	// changes the outcome of a game draws from the stream of its GameInstance so that it can be replayed.
+	static float Float()
+	{
+		return s_MainStream.Float();
+	}
+
+	static void Fill(float* out, size_t count)
+	{
+		s_MainStream.Fill(out, count);
+	}
+
+private:
+	static uint64_t s_MasterSeed;
+	static RandomStream s_Streams;
+	static RandomStream s_MainStream;
+	static std::mutex s_StreamsMutex;
+};
@@ -2,29 +2,32 @@
 #include "render.hpp"
 #include "render_components.hpp"
 
+#include "animation.hpp"
 #include "entities/slingbro.hpp"
 
 #include "world.hpp"
 #include "text.hpp"
 
 #include <iostream>
+#include <limits>
 
-void RenderSystem::drawTexturedMesh(ECS_ENTT::Entity entity, const mat4& view, const mat4& projection)
+void RenderSystem::drawTexturedMesh(entt::registry& registry, entt::entity entity, const mat4& view, const mat4& projection)
 {
-	auto& motion = entity.GetComponent<Motion>();
-	auto& texmesh = *entity.GetComponent<ShadedMeshRef>().reference_to_cache;
+	auto [motion, meshRef] = registry.get<Motion, ShadedMeshRef>(entity);
+	assert(ResourceCache::is_valid(meshRef.handle) && "Drawing an entity whose resource has been unloaded");
+	auto& texmesh = *meshRef.reference_to_cache;
 
 	// Transformation code, see Rendering and Transformation in the template specification for more info
 	// Incrementally updates transformation matrix, thus ORDER IS IMPORTANT
 	Transform transform;
 	transform.translate(motion.position);
 	// Process any deformations 
-	if (entity.HasComponent<Deformation>())
+	const Deformation* deformation = registry.try_get<Deformation>(entity);
+	if (deformation && deformation->active)
 	{
-		Deformation& deformationComponent = entity.GetComponent<Deformation>();
-		transform.rotate(deformationComponent.angleRadians, glm::vec3(0.0f, 0.0f, 1.0f));
-		transform.scale(glm::vec3(deformationComponent.scaleX, deformationComponent.scaleY, 0.0f));
-		transform.rotate(-deformationComponent.angleRadians, glm::vec3(0.0f, 0.0f, 1.0f));
+		transform.rotate(deformation->angleRadians, glm::vec3(0.0f, 0.0f, 1.0f));
+		transform.scale(glm::vec3(deformation->scaleX, deformation->scaleY, 0.0f));
+		transform.rotate(-deformation->angleRadians, glm::vec3(0.0f, 0.0f, 1.0f));
 	}
 	transform.rotate(motion.angle, glm::vec3(0.0f, 0.0f, 1.0f));
 	transform.scale(motion.scale);
@@ -70,18 +73,6 @@ void RenderSystem::drawTexturedMesh(ECS_ENTT::Entity entity, const mat4& view, c
 		glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(ColoredVertex), reinterpret_cast<void*>(0));
 		glEnableVertexAttribArray(in_color_loc);
 		glVertexAttribPointer(in_color_loc, 3, GL_FLOAT, GL_FALSE, sizeof(ColoredVertex), reinterpret_cast<void*>(sizeof(vec3)));
-
-		if (entity.HasComponent<LightUp>())
-		{
-			GLint light_up_uloc = glGetUniformLocation(texmesh.effect.program, "light_up");
-			auto& lightUpComponent = entity.GetComponent<LightUp>();
-			glUniform1i(light_up_uloc, (GLint)lightUpComponent.isLit);
-		}
-		else
-		{
-			GLint light_up_uloc = glGetUniformLocation(texmesh.effect.program, "light_up");
-			glUniform1i(light_up_uloc, (GLint)0);
-		}
 	}
 	else
 	{
@@ -225,8 +216,10 @@ void RenderSystem::drawToScreen()
 void RenderSystem::drawParticlesInstanced(ParticleSystem* particleSystem, const mat4& view, const mat4& projection)
 {
 	int index = 0;
-	for (const Particle& particle : particleSystem->GetActiveParticles())
+	for (const Particle& particle : particleSystem->GetParticles())
 	{
+		if (!particle.active)
+			continue;
 		Transform transform;
 		// Set transform instance
 		transform.translate(particle.position);
@@ -351,6 +344,275 @@ void RenderSystem::drawBee(Bee bee, ShadedMesh* beeMesh, const mat4& view, const
 	glBindVertexArray(0);
 }
 
+Frustum::Frustum(const mat4& viewProjection)
+{
+	// Gribb/Hartmann plane extraction, glm matrices are indexed [column][row]
+	vec4 rows[4];
+	for (int i = 0; i < 4; i++)
+		rows[i] = vec4(viewProjection[0][i], viewProjection[1][i], viewProjection[2][i], viewProjection[3][i]);
+
+	planes[0] = rows[3] + rows[0]; // left
+	planes[1] = rows[3] - rows[0]; // right
+	planes[2] = rows[3] + rows[1]; // bottom
+	planes[3] = rows[3] - rows[1]; // top
+	planes[4] = rows[3] + rows[2]; // near
+	planes[5] = rows[3] - rows[2]; // far
+
+	for (vec4& plane : planes)
+		plane /= glm::length(vec3(plane));
+}
+
+bool Frustum::intersects(vec3 center, float radius) const
+{
+	for (const vec4& plane : planes)
+	{
+		if (glm::dot(vec3(plane), center) + plane.w < -radius)
+			return false;
+	}
+	return true;
+}
+
+// Radius of a sphere containing the sprite, whatever its rotation and deformation
+static float bounding_radius(const Motion& motion, const Deformation* deformation)
+{
+	float radius = 0.5f * glm::length(vec2(motion.scale));
+	if (deformation && deformation->active)
+		radius *= max(1.0f, max(std::abs(deformation->scaleX), std::abs(deformation->scaleY)));
+	return radius;
+}
+
+// Opaque meshes only write fully covered pixels, so drawing them front to back lets the
+// depth test reject everything hidden behind them before it is shaded
+static bool is_opaque(const ShadedMesh& mesh)
+{
+	return mesh.texture.is_opaque && mesh.texture.color.a >= 1.0f;
+}
+
+void RenderSystem::updateTileChunks(ECS_ENTT::Scene* scene)
+{
+	int numChunks = scene->GetNumChunkRows() * scene->GetNumChunkCols();
+	int firstDirty = 0;
+	while (firstDirty < numChunks && !scene->IsTileChunkDirty(firstDirty))
+		firstDirty++;
+	if (firstDirty == numChunks)
+		return;
+
+	// Create the missing chunks first, since adding a component can move the others in memory
+	tileChunks.assign(numChunks, nullptr);
+	for (auto [entityID, existing] : scene->m_Registry.view<TileChunk>().each())
+		tileChunks[existing.index] = &existing;
+	bool created = false;
+	for (int index = firstDirty; index < numChunks; index++)
+	{
+		if (scene->IsTileChunkDirty(index) && !tileChunks[index])
+		{
+			scene->CreateEntity("Tile Chunk").AddComponent<TileChunk>().index = index;
+			created = true;
+		}
+	}
+	if (created)
+	{
+		for (auto [entityID, existing] : scene->m_Registry.view<TileChunk>().each())
+			tileChunks[existing.index] = &existing;
+	}
+
+	for (int index = firstDirty; index < numChunks; index++)
+	{
+		if (!scene->IsTileChunkDirty(index))
+			continue;
+		buildTileChunk(scene, *tileChunks[index]);
+		scene->CleanTileChunk(index);
+	}
+}
+
+void RenderSystem::buildTileChunk(ECS_ENTT::Scene* scene, TileChunk& chunk)
+{
+	auto& registry = scene->m_Registry;
+	int firstRow = (chunk.index / scene->GetNumChunkCols()) * TILE_CHUNK_SIZE;
+	int firstCol = (chunk.index % scene->GetNumChunkCols()) * TILE_CHUNK_SIZE;
+
+	// Vertices and indices of each batch, in the same order as the chunk's batches
+	std::vector<std::vector<TexturedVertex>> batchVertices;
+	std::vector<std::vector<uint16_t>> batchIndices;
+	chunk.batches.clear();
+
+	vec3 boundsMin = vec3(std::numeric_limits<float>::max());
+	vec3 boundsMax = vec3(std::numeric_limits<float>::lowest());
+	for (int row = firstRow; row < min(firstRow + TILE_CHUNK_SIZE, scene->GetNumRows()); row++)
+	{
+		for (int col = firstCol; col < min(firstCol + TILE_CHUNK_SIZE, scene->GetNumCols()); col++)
+		{
+			entt::entity tile = scene->GetTile(row, col);
+			if (tile == entt::null || !registry.has<ShadedMeshRef, Motion>(tile))
+				continue;
+
+			// Tiles whose sprite changes over time, or isn't a plain quad, keep being drawn on their own
+			ShadedMesh& sprite = *registry.get<ShadedMeshRef>(tile).reference_to_cache;
+			if (registry.has<Animation>(tile) || registry.has<Deformation>(tile) || !sprite.mesh.is_quad)
+			{
+				registry.remove_if_exists<BakedTile>(tile);
+				continue;
+			}
+
+			size_t batch = 0;
+			while (batch < chunk.batches.size() && chunk.batches[batch].source.reference_to_cache != &sprite)
+				batch++;
+			if (batch == chunk.batches.size())
+			{
+				chunk.batches.push_back({ ShadedMeshRef(sprite) });
+				batchVertices.emplace_back();
+				batchIndices.emplace_back();
+			}
+
+			const Motion& motion = registry.get<Motion>(tile);
+			Transform transform;
+			transform.translate(motion.position);
+			transform.rotate(motion.angle, glm::vec3(0.0f, 0.0f, 1.0f));
+			transform.scale(motion.scale);
+
+			auto& vertices = batchVertices[batch];
+			auto& indices = batchIndices[batch];
+			uint16_t base = (uint16_t)vertices.size();
+			for (TexturedVertex vertex : sprite.mesh.quad)
+			{
+				vertex.position = vec3(transform.matrix * vec4(vertex.position, 1.0f));
+				boundsMin = glm::min(boundsMin, vertex.position);
+				boundsMax = glm::max(boundsMax, vertex.position);
+				vertices.push_back(vertex);
+			}
+			for (uint16_t index : { 0, 3, 1, 1, 3, 2 })
+				indices.push_back(base + index);
+
+			registry.emplace_or_replace<BakedTile>(tile);
+		}
+	}
+
+	for (size_t batch = 0; batch < chunk.batches.size(); batch++)
+	{
+		Mesh& mesh = chunk.batches[batch].mesh;
+		glGenVertexArrays(1, mesh.vao.data());
+		glGenBuffers(1, mesh.vbo.data());
+		glGenBuffers(1, mesh.ibo.data());
+		glBindVertexArray(mesh.vao);
+		glBindBuffer(GL_ARRAY_BUFFER, mesh.vbo);
+		glBufferData(GL_ARRAY_BUFFER, sizeof(TexturedVertex) * batchVertices[batch].size(), batchVertices[batch].data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mesh.ibo);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(uint16_t) * batchIndices[batch].size(), batchIndices[batch].data(), GL_STATIC_DRAW);
+		glBindVertexArray(0);
+		gl_has_errors();
+		chunk.batches[batch].num_indices = (GLsizei)batchIndices[batch].size();
+	}
+
+	chunk.center = (boundsMin + boundsMax) * 0.5f;
+	chunk.radius = chunk.batches.empty() ? 0.f : glm::length(boundsMax - boundsMin) * 0.5f;
+}
+
+void RenderSystem::drawTileChunkBatch(const TileChunk::Batch& batch, const mat4& view, const mat4& projection)
+{
+	const ShadedMesh& sprite = *batch.source.reference_to_cache;
+
+	// Setting shaders
+	glUseProgram(sprite.effect.program);
+	glBindVertexArray(batch.mesh.vao);
+	gl_has_errors();
+
+	// Enabling alpha channel and depth test for textures
+	glEnable(GL_BLEND); glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	glEnable(GL_DEPTH_TEST);
+	gl_has_errors();
+
+	GLuint time_uloc = glGetUniformLocation(sprite.effect.program, "time");
+	GLint transform_uloc = glGetUniformLocation(sprite.effect.program, "transform");
+	GLint view_uloc = glGetUniformLocation(sprite.effect.program, "view");
+	GLint projection_uloc = glGetUniformLocation(sprite.effect.program, "projection");
+	GLint color_uloc = glGetUniformLocation(sprite.effect.program, "fcolor");
+	gl_has_errors();
+
+	// Setting vertex and index buffers
+	glBindBuffer(GL_ARRAY_BUFFER, batch.mesh.vbo);
+	glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch.mesh.ibo);
+	gl_has_errors();
+
+	GLint in_position_loc = glGetAttribLocation(sprite.effect.program, "in_position");
+	GLint in_texcoord_loc = glGetAttribLocation(sprite.effect.program, "in_texcoord");
+	glEnableVertexAttribArray(in_position_loc);
+	glVertexAttribPointer(in_position_loc, 3, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), reinterpret_cast<void*>(0));
+	glEnableVertexAttribArray(in_texcoord_loc);
+	glVertexAttribPointer(in_texcoord_loc, 2, GL_FLOAT, GL_FALSE, sizeof(TexturedVertex), reinterpret_cast<void*>(sizeof(vec3)));
+	glActiveTexture(GL_TEXTURE0);
+	glBindTexture(GL_TEXTURE_2D, sprite.texture.texture_id);
+	gl_has_errors();
+
+	// The vertices are already in world space
+	mat4 identity = mat4(1.0f);
+	glUniform1f(time_uloc, static_cast<float>(glfwGetTime() * 10.0f));
+	glUniform4fv(color_uloc, 1, (float*)&sprite.texture.color);
+	glUniformMatrix4fv(transform_uloc, 1, GL_FALSE, (float*)&identity);
+	glUniformMatrix4fv(view_uloc, 1, GL_FALSE, (float*)&view);
+	glUniformMatrix4fv(projection_uloc, 1, GL_FALSE, (float*)&projection);
+	gl_has_errors();
+
+	glDrawElements(GL_TRIANGLES, batch.num_indices, GL_UNSIGNED_SHORT, nullptr);
+	glBindVertexArray(0);
+}
+
+void RenderSystem::collectVisibleMeshes(ECS_ENTT::Scene* scene, const Frustum& frustum, const mat4& view)
+{
+	opaqueDrawList.clear();
+	transparentDrawList.clear();
+	auto& registry = scene->m_Registry;
+
+	// The camera looks down -z in view space, so the depth is the negated view space z
+	auto depthOf = [&](vec3 position) { return -(view * vec4(position, 1.0f)).z; };
+
+	for (auto [entityID, chunk] : registry.view<TileChunk>().each())
+	{
+		if (chunk.batches.empty() || !frustum.intersects(chunk.center, chunk.radius))
+			continue;
+		float depth = depthOf(chunk.center);
+		for (int batch = 0; batch < (int)chunk.batches.size(); batch++)
+		{
+			if (is_opaque(*chunk.batches[batch].source.reference_to_cache))
+				opaqueDrawList.push_back({ entityID, depth, batch });
+			else
+				transparentDrawList.push_back({ entityID, depth, batch });
+		}
+	}
+
+	for (auto [entityID, meshRef, motion] : registry.view<ShadedMeshRef, Motion>(entt::exclude<BakedTile>).each())
+	{
+		if (!frustum.intersects(motion.position, bounding_radius(motion, registry.try_get<Deformation>(entityID))))
+			continue;
+		if (is_opaque(*meshRef.reference_to_cache))
+			opaqueDrawList.push_back({ entityID, depthOf(motion.position) });
+		else
+			transparentDrawList.push_back({ entityID, depthOf(motion.position) });
+	}
+
+	// Most sprites share a depth, so ties are broken by entity and batch. The views hand them out in
+	// storage order, which changes as entities come and go, and overlapping sprites would flicker.
+	auto tie = [](const DrawItem& a, const DrawItem& b) {
+		if (a.entity != b.entity)
+			return entt::to_integral(a.entity) < entt::to_integral(b.entity);
+		return a.batch < b.batch;
+	};
+	std::sort(opaqueDrawList.begin(), opaqueDrawList.end(), [&tie](const DrawItem& a, const DrawItem& b) {
+		return a.depth != b.depth ? a.depth < b.depth : tie(a, b);
+	});
+	std::sort(transparentDrawList.begin(), transparentDrawList.end(), [&tie](const DrawItem& a, const DrawItem& b) {
+		return a.depth != b.depth ? a.depth > b.depth : tie(a, b);
+	});
+}
+
+void RenderSystem::drawItem(ECS_ENTT::Scene* scene, const DrawItem& item, const mat4& view, const mat4& projection)
+{
+	if (item.batch >= 0)
+		drawTileChunkBatch(scene->m_Registry.get<TileChunk>(item.entity).batches[item.batch], view, projection);
+	else
+		drawTexturedMesh(scene->m_Registry, item.entity, view, projection);
+	gl_has_errors();
+}
+
 // Render our game world
 // http://www.opengl-tutorial.org/intermediate-tutorials/tutorial-14-render-to-texture/
 void RenderSystem::draw(vec2 window_size_in_game_units, Camera& activeCamera, ParticleSystem* particleSystem)
@@ -375,17 +637,15 @@ void RenderSystem::draw(vec2 window_size_in_game_units, Camera& activeCamera, Pa
 	glm::mat4 viewMatrix = activeCamera.GetViewMatrix();
 	glm::mat4 projMatrix = activeCamera.GetProjectionMatrix(); 
 
-	// Draw all textured meshes that have a position and size component
+	// Draw the textured meshes inside of the camera's view, opaque ones front to back
+	// and then the blended ones back to front so they blend with what is behind them
 	ECS_ENTT::Scene* scene = WorldSystem::ActiveScene;
-	for (auto entityID : scene->m_Registry.view<ShadedMeshRef>())
-	{
-		ECS_ENTT::Entity entity{ entityID, scene };
-		if (!entity.HasComponent<Motion>())
-			continue;
-		// Note, its not very efficient to access elements indirectly via the entity albeit iterating through all Sprites in sequence
-		drawTexturedMesh(entity, viewMatrix, projMatrix);
-		gl_has_errors();
-	}
+	updateTileChunks(scene);
+	collectVisibleMeshes(scene, Frustum(projMatrix * viewMatrix), viewMatrix);
+	for (const DrawItem& item : opaqueDrawList)
+		drawItem(scene, item, viewMatrix, projMatrix);
+	for (const DrawItem& item : transparentDrawList)
+		drawItem(scene, item, viewMatrix, projMatrix);
 
 	// Draw all particles:
 	// Using instancing
@@ -415,10 +675,9 @@ void RenderSystem::draw(vec2 window_size_in_game_units, Camera& activeCamera, Pa
 	// for nearly all use cases. If you need text to appear behind meshes,
 	// consider using a depth buffer during rendering and adding a
 	// Z-component or depth index to all rendererable components.
-	for (auto entityID : scene->m_Registry.view<Text>()) {
-		const Text& text = scene->m_Registry.get<Text>(entityID);
+	scene->m_Registry.view<Text>().each([window_size_in_game_units](const Text& text) {
 		drawText(text, window_size_in_game_units);
-	}
+	});
 	
 	// Truely render to the screen
 	drawToScreen();
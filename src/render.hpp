@@ -15,6 +15,19 @@ struct ShadedMesh;
 // OpenGL utilities
 void gl_has_errors();
 
+// Clipping planes of a camera, used to skip entities that can't be seen
+struct Frustum
+{
+	// Planes point inwards and are normalized, stored as (normal, distance)
+	vec4 planes[6];
+
+	// Extracts the planes from a combined projection * view matrix
+	explicit Frustum(const mat4& viewProjection);
+
+	// True if a sphere is at least partially inside of the frustum
+	bool intersects(vec3 center, float radius) const;
+};
+
 // System responsible for setting up OpenGL and for rendering all the 
 // visual entities in the game
 class RenderSystem
@@ -44,12 +57,31 @@ private:
 	void initScreenTexture();
 
 	// Internal drawing functions for each entity type
-	void drawTexturedMesh(ECS_ENTT::Entity entity, const mat4& view, const mat4& projection);
+	void drawTexturedMesh(entt::registry& registry, entt::entity entity, const mat4& view, const mat4& projection);
 	void drawParticle(Particle particle, ShadedMesh* particleMesh, const mat4& view, const mat4& projection);
 	void drawParticlesInstanced(ParticleSystem* particleSystem, const mat4& view, const mat4& projection);
 	void drawBee(Bee bee, ShadedMesh* beeMesh, const mat4& view, const mat4& projection);
 	void drawToScreen();
 
+	// Rebuilds the vertex buffers of the tile chunks whose tiles changed since they were last built
+	void updateTileChunks(ECS_ENTT::Scene* scene);
+	void buildTileChunk(ECS_ENTT::Scene* scene, TileChunk& chunk);
+	void drawTileChunkBatch(const TileChunk::Batch& batch, const mat4& view, const mat4& projection);
+
+	// Collects the visible textured meshes into the opaque and transparent draw lists, sorted for drawing
+	void collectVisibleMeshes(ECS_ENTT::Scene* scene, const Frustum& frustum, const mat4& view);
+
+	// An entity to draw and its distance from the camera along the view direction.
+	// For tile chunks, batch is the index of the chunk's batch to draw.
+	struct DrawItem
+	{
+		entt::entity entity;
+		float depth;
+		int batch = -1;
+	};
+
+	void drawItem(ECS_ENTT::Scene* scene, const DrawItem& item, const mat4& view, const mat4& projection);
+
 	// Window handle
 	GLFWwindow& window;
 
@@ -66,4 +98,11 @@ private:
 	// Keep track of instancing vertex buffers
 	unsigned int instanced_colours_VBO;
 	unsigned int instanced_transforms_VBO;
+
+	// Reused every frame so that collecting the visible entities doesn't allocate
+	std::vector<DrawItem> opaqueDrawList;
+	std::vector<DrawItem> transparentDrawList;
+
+	// Chunk of each chunk index, looked up once per frame that has chunks to rebuild
+	std::vector<TileChunk*> tileChunks;
 };
@@ -6,6 +6,7 @@
 
 // stlib
 #include <array>
+#include <deque>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -66,6 +67,16 @@ void Texture::load_from_file(std::string path)
 		throw std::runtime_error("data == NULL, failed to load texture");
 	gl_has_errors();
 
+	is_opaque = true;
+	for (int i = 3; i < size.x * size.y * 4; i += 4)
+	{
+		if (data[i] < 255)
+		{
+			is_opaque = false;
+			break;
+		}
+	}
+
 	glGenTextures(1, texture_id.data());
 	glBindTexture(GL_TEXTURE_2D, texture_id);
 	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, size.x, size.y, 0, GL_RGBA, GL_UNSIGNED_BYTE, data);
@@ -266,20 +277,153 @@ void Mesh::loadFromOBJFile(std::string obj_path) {
     }
 }
 
+namespace
+{
+	struct ResourceSlot
+	{
+		ShadedMesh mesh;
+		ResourceKey key = 0;
+		uint32_t generation = 0;
+		uint32_t refCount = 0;
+		ResourceLifetime lifetime = ResourceLifetime::Game;
+		bool loaded = false;
+	};
+
+	struct ResourceRegistry
+	{
+		// A deque never moves its elements, so pointers to cached meshes stay valid as it grows
+		std::deque<ResourceSlot> slots;
+		std::unordered_map<ResourceKey, uint32_t> indices;
+		std::vector<uint32_t> freeSlots;
+	};
+
+	ResourceRegistry& resource_registry()
+	{
+		static ResourceRegistry registry;
+		return registry;
+	}
+
+	void unload(uint32_t index)
+	{
+		auto& registry = resource_registry();
+		ResourceSlot& slot = registry.slots[index];
+		registry.indices.erase(slot.key);
+
+		// Replacing the mesh frees its OpenGL resources, the new generation invalidates old handles
+		slot.mesh = ShadedMesh{};
+		slot.generation++;
+		slot.loaded = false;
+		registry.freeSlots.push_back(index);
+	}
+}
+
 // Returns a resource for every key, initializing with zero on the first query
-ShadedMesh& cache_resource(std::string key) 
+ShadedMesh& cache_resource(ResourceKey key, ResourceLifetime lifetime)
 {
-	static std::unordered_map<std::string, ShadedMesh> resource_cache;
-	const auto it = resource_cache.find(key);
-	if (it == resource_cache.end())
+	auto& registry = resource_registry();
+	const auto it = registry.indices.find(key);
+	if (it != registry.indices.end())
+		return registry.slots[it->second].mesh;
+
+	uint32_t index;
+	if (!registry.freeSlots.empty())
 	{
-		const auto it_succeeded = resource_cache.emplace(key, ShadedMesh{});
-		assert(it_succeeded.second);
-		return it_succeeded.first->second;
+		index = registry.freeSlots.back();
+		registry.freeSlots.pop_back();
 	}
-	return it->second;
+	else
+	{
+		index = (uint32_t)registry.slots.size();
+		registry.slots.emplace_back();
+	}
+
+	ResourceSlot& slot = registry.slots[index];
+	slot.key = key;
+	slot.refCount = 0;
+	slot.lifetime = lifetime;
+	slot.loaded = true;
+	slot.mesh.handle = { index, slot.generation };
+	registry.indices.emplace(key, index);
+	return slot.mesh;
 }
 
-ShadedMeshRef::ShadedMeshRef(ShadedMesh& mesh) : 
-	reference_to_cache(&mesh) 
-{};
\ No newline at end of file
+bool ResourceCache::is_valid(ResourceHandle handle)
+{
+	auto& registry = resource_registry();
+	return handle.index < registry.slots.size()
+		&& registry.slots[handle.index].loaded
+		&& registry.slots[handle.index].generation == handle.generation;
+}
+
+ShadedMesh& ResourceCache::get(ResourceHandle handle)
+{
+	assert(is_valid(handle) && "Stale resource handle, the resource has been unloaded");
+	return resource_registry().slots[handle.index].mesh;
+}
+
+void ResourceCache::retain(ResourceHandle handle)
+{
+	assert(is_valid(handle) && "Stale resource handle, the resource has been unloaded");
+	resource_registry().slots[handle.index].refCount++;
+}
+
+void ResourceCache::release(ResourceHandle handle)
+{
+	assert(is_valid(handle) && "Stale resource handle, the resource has been unloaded");
+	ResourceSlot& slot = resource_registry().slots[handle.index];
+	assert(slot.refCount > 0);
+	if (--slot.refCount == 0 && slot.lifetime == ResourceLifetime::Level)
+		unload(handle.index);
+}
+
+size_t ResourceCache::size()
+{
+	return resource_registry().indices.size();
+}
+
+ShadedMeshRef::ShadedMeshRef(ShadedMesh& mesh) :
+	reference_to_cache(&mesh),
+	handle(mesh.handle)
+{
+	ResourceCache::retain(handle);
+}
+
+ShadedMeshRef::ShadedMeshRef(const ShadedMeshRef& other) :
+	reference_to_cache(other.reference_to_cache),
+	handle(other.handle)
+{
+	if (reference_to_cache)
+		ResourceCache::retain(handle);
+}
+
+ShadedMeshRef::ShadedMeshRef(ShadedMeshRef&& other) noexcept :
+	reference_to_cache(std::exchange(other.reference_to_cache, nullptr)),
+	handle(other.handle)
+{}
+
+ShadedMeshRef& ShadedMeshRef::operator=(const ShadedMeshRef& other)
+{
+	if (this != &other)
+	{
+		ShadedMeshRef copy(other);
+		*this = std::move(copy);
+	}
+	return *this;
+}
+
+ShadedMeshRef& ShadedMeshRef::operator=(ShadedMeshRef&& other) noexcept
+{
+	if (this != &other)
+	{
+		std::swap(reference_to_cache, other.reference_to_cache);
+		std::swap(handle, other.handle);
+	}
+	return *this;
+}
+
+ShadedMeshRef::~ShadedMeshRef()
+{
+	// Moved-from references don't own a count
+	if (reference_to_cache)
+		ResourceCache::release(handle);
+}
@@ -1,9 +1,15 @@
 #pragma once
 #include "common.hpp"
+#include <array>
+#include <limits>
 #include <vector>
 #include <unordered_map>
+#include "entt.hpp"
+#include "timer_queue.hpp"
 #include "../ext/stb_image/stb_image.h"
 
+using namespace entt::literals;
+
 enum GLResourceType {BUFFER, RENDER_BUFFER, SHADER, PROGRAM, TEXTURE, VERTEX_ARRAY};
 
 // This class is a wrapper around OpenGL resources that deletes allocated memory on destruction.
@@ -78,6 +84,9 @@ struct Texture
 	ivec2 size = {0, 0};
 	glm::vec4 color = { 1.0f, 1.0f, 1.0f, 1.0f};
 
+	// True if every texel is fully opaque, so the texture can be drawn without blending in front-to-back order
+	bool is_opaque = false;
+
 	// Loads texture from file specified by path
 	void load_from_file(std::string path);
 	bool is_valid() const; // True if texture is valid
@@ -107,6 +116,10 @@ struct Mesh
 	GLResource<VERTEX_ARRAY> vao;
 	std::vector<ColoredVertex> vertices;
 	std::vector<uint16_t> vertex_indices;
+
+	// Corners of sprites made by createSprite, kept so tile chunks can be baked without reading the GPU
+	std::array<TexturedVertex, 4> quad;
+	bool is_quad = false;
 };
 
 struct ScreenState
@@ -114,22 +127,68 @@ struct ScreenState
 	float darken_screen_factor = -1;
 };
 
+// Interned name of a cached resource, use "name"_hs for keys known at compile time
+using ResourceKey = entt::id_type;
+
+// Handle to a slot of the resource cache. The generation changes whenever the slot is unloaded,
+// so handles to a resource that has since been unloaded can be detected.
+struct ResourceHandle
+{
+	uint32_t index = std::numeric_limits<uint32_t>::max();
+	uint32_t generation = 0;
+};
+
+// How long a cached resource is kept around
+enum class ResourceLifetime
+{
+	Game,	// Until the game closes, e.g. tile sprites shared by every level
+	Level	// Until no entity refers to it anymore, e.g. a level's background
+};
+
 // ShadedMesh datastructure for storing mesh, shader, and texture objects
 struct ShadedMesh
 {
 	Mesh mesh;
 	Effect effect;
 	Texture texture;
+
+	// Slot of this mesh in the resource cache
+	ResourceHandle handle;
 };
 
 // Cache for ShadedMesh resources (mesh consisting of vertex and index buffer, the vertex and fragment shaders, and the texture)
-ShadedMesh& cache_resource(std::string key);
+ShadedMesh& cache_resource(ResourceKey key, ResourceLifetime lifetime = ResourceLifetime::Game);
 
-// A wrapper that points to the ShadedMesh in the resource_cache
+// Interns a key that is only known at load time, e.g. a file name read from a level
+inline ResourceKey resource_key(const std::string& name) { return entt::hashed_string::value(name.c_str()); }
+
+namespace ResourceCache
+{
+	// True if the handle still refers to the resource it was created for
+	bool is_valid(ResourceHandle handle);
+
+	ShadedMesh& get(ResourceHandle handle);
+
+	// Reference counting, level resources are unloaded once their count drops to zero
+	void retain(ResourceHandle handle);
+	void release(ResourceHandle handle);
+
+	// Number of resources currently in the cache
+	size_t size();
+}
+
+// A wrapper that points to the ShadedMesh in the resource_cache and keeps it loaded
 struct ShadedMeshRef
 {
 	ShadedMesh* reference_to_cache;
+	ResourceHandle handle;
+
 	ShadedMeshRef(ShadedMesh& mesh);
+	ShadedMeshRef(const ShadedMeshRef& other);
+	ShadedMeshRef(ShadedMeshRef&& other) noexcept;
+	ShadedMeshRef& operator=(const ShadedMeshRef& other);
+	ShadedMeshRef& operator=(ShadedMeshRef&& other) noexcept;
+	~ShadedMeshRef();
 };
 
 // A struct to refer to debugging graphics in the ECS
@@ -141,18 +200,28 @@ struct DebugComponent
 	uint32_t placeholder = 0;
 };
 
-// A timer that will be associated to dying salmon
-struct DeathTimer
+// Static tiles of one chunk of the level map, pre-transformed into one vertex buffer per texture
+// so that the whole chunk is drawn in a few draw calls. Lives on its own entity in the scene.
+struct TileChunk
 {
-	float counter_ms = 1000;
+	struct Batch
+	{
+		// Keeps the tiles' texture and shader loaded for as long as the batch exists
+		ShadedMeshRef source;
+		Mesh mesh;
+		GLsizei num_indices = 0;
+	};
+
+	int index = 0;
+	std::vector<Batch> batches;
+
+	// Bounding sphere of the tiles, for culling
+	vec3 center = vec3(0);
+	float radius = 0.f;
 };
 
-// Light up an entity
-struct LightUp
+// Marks a tile that is drawn as part of its TileChunk rather than on its own
+struct BakedTile
 {
-	LightUp() = default;
-	LightUp(bool b)
-		: isLit(b) {}
-	bool isLit = true;
-	float counter_ms = 1000;
+	uint32_t placeholder = 0;
 };
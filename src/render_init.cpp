@@ -4,6 +4,7 @@
 
 #include "world.hpp"
 
+#include <algorithm>
 #include <iostream>
 #include <fstream>
 
@@ -120,6 +121,9 @@ void RenderSystem::createSprite(ShadedMesh& sprite, std::string texture_path, st
 	// Counterclockwise as it's the default opengl front winding direction.
 	uint16_t indices[] = { 0, 3, 1, 1, 3, 2 };
 
+	std::copy(std::begin(vertices), std::end(vertices), sprite.mesh.quad.begin());
+	sprite.mesh.is_quad = true;
+
 	glGenVertexArrays(1, sprite.mesh.vao.data());
 	glGenBuffers(1, sprite.mesh.vbo.data());
 	glGenBuffers(1, sprite.mesh.ibo.data());
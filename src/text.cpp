@@ -3,7 +3,6 @@
 #include <common.hpp>
 #include <render.hpp>
 
-#include <codecvt>
 #include <iomanip>
 #include <iostream>
 #include <locale>
@@ -441,13 +440,44 @@ const TextFont::Character& TextFont::getCharacter(std::uint32_t codePoint) {
  * the `u8` string literal prefix, as in `u8"some international text"`.
  * See https://en.cppreference.com/w/cpp/language/string_literal
  */
-std::u32string utf8ToUtf32(const std::string& str) {
-    // NOTE: std::wstring_convert was introduced in C++11 and then
-    // spontaneously deprecated in C++17 without any replacement.
-    // Non-ASCII handling in C++ sucks in general. This will hopefully
-    // improve in C++23 but who can say.
-    using convert_t = std::wstring_convert<std::codecvt_utf8<char32_t>, char32_t>;
-    return convert_t{}.from_bytes(str);
+void utf8ToUtf32(const std::string& str, std::u32string& out) {
+    // Decoded by hand into the caller's buffer, since std::wstring_convert
+    // allocates a new string for every call and drawText runs every frame.
+    // Malformed sequences decode to U+FFFD rather than throwing.
+    out.clear();
+    size_t i = 0;
+    while (i < str.size()) {
+        const auto lead = static_cast<unsigned char>(str[i]);
+        size_t length;
+        char32_t codePoint;
+        if (lead < 0x80) {
+            length = 1;
+            codePoint = lead;
+        } else if ((lead & 0xE0) == 0xC0) {
+            length = 2;
+            codePoint = lead & 0x1F;
+        } else if ((lead & 0xF0) == 0xE0) {
+            length = 3;
+            codePoint = lead & 0x0F;
+        } else if ((lead & 0xF8) == 0xF0) {
+            length = 4;
+            codePoint = lead & 0x07;
+        } else {
+            out.push_back(U'\uFFFD');
+            ++i;
+            continue;
+        }
+
+        size_t j = 1;
+        for (; j < length && i + j < str.size(); ++j) {
+            const auto continuation = static_cast<unsigned char>(str[i + j]);
+            if ((continuation & 0xC0) != 0x80)
+                break;
+            codePoint = (codePoint << 6) | (continuation & 0x3F);
+        }
+        out.push_back(j == length ? codePoint : U'\uFFFD');
+        i += j;
+    }
 }
 
 void drawText(const Text& text, glm::vec2 gameUnitSize) {
@@ -499,8 +529,10 @@ void drawText(const Text& text, glm::vec2 gameUnitSize) {
     gl_has_errors();
 
 
-    // Convert ASCII/UTF-8 text to Unicode code points
-    const auto u32str = utf8ToUtf32(text.content);
+    // Convert ASCII/UTF-8 text to Unicode code points, reusing
+    // the buffer of the previous call
+    static std::u32string u32str;
+    utf8ToUtf32(text.content, u32str);
 
     // For each Unicode code point
 	for (const auto& c : u32str) {
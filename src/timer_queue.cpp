@@ -0,0 +1,39 @@
+#include "timer_queue.hpp"
+
+#include <algorithm>
+
+// Timers in flight a scene starts with room for, so the queue doesn't grow during play
+const size_t TIMER_QUEUE_INITIAL_CAPACITY = 256;
+
+TimerQueue::TimerQueue()
+{
+	m_Heap.reserve(TIMER_QUEUE_INITIAL_CAPACITY);
+	for (auto& batch : m_Expired)
+		batch.reserve(TIMER_QUEUE_INITIAL_CAPACITY);
+}
+
+TimerId TimerQueue::schedule(TimerKind kind, entt::entity entity, float delay_ms)
+{
+	TimerId id = m_NextId++;
+	if (m_NextId == 0)
+		m_NextId = 1;
+
+	m_Heap.push_back({ m_Now + delay_ms, id, entity, kind });
+	std::push_heap(m_Heap.begin(), m_Heap.end(), later);
+	return id;
+}
+
+void TimerQueue::advance(float elapsed_ms)
+{
+	for (auto& batch : m_Expired)
+		batch.clear();
+
+	m_Now += elapsed_ms;
+	while (!m_Heap.empty() && m_Heap.front().expiresAt <= m_Now)
+	{
+		std::pop_heap(m_Heap.begin(), m_Heap.end(), later);
+		const Entry& entry = m_Heap.back();
+		m_Expired[(size_t)entry.kind].push_back({ entry.entity, entry.id });
+		m_Heap.pop_back();
+	}
+}
@@ -0,0 +1,58 @@
+#pragma once
+
+#include "entt.hpp"
+
+#include <array>
+#include <cstdint>
+#include <vector>
+
+// Timed effects run by a scene's timer queue, expired timers are handed out in one batch per kind
+enum class TimerKind : uint8_t
+{
+	Deformation,
+	ProjectileLifetime,
+	Count
+};
+
+// Identifies one scheduled timer, 0 is never handed out so it can mean "no timer"
+using TimerId = uint32_t;
+
+struct TimerEvent
+{
+	entt::entity entity;
+	TimerId id;
+};
+
+// Sorted expiry heap of a scene's timed effects, so thousands of them cost nothing until they expire.
+// Timers can't be cancelled: components remember the id of their current timer, and ignore
+// the expiry of any other one, e.g. after being deformed again or returned to the pool.
+class TimerQueue
+{
+public:
+	TimerQueue();
+
+	TimerId schedule(TimerKind kind, entt::entity entity, float delay_ms);
+
+	// Advances the clock, and moves every timer expiring by then into the batch of its kind
+	void advance(float elapsed_ms);
+
+	// Timers of a kind that expired during the last advance, in expiry order
+	const std::vector<TimerEvent>& expired(TimerKind kind) const { return m_Expired[(size_t)kind]; }
+
+private:
+	struct Entry
+	{
+		double expiresAt;
+		TimerId id;
+		entt::entity entity;
+		TimerKind kind;
+	};
+
+	static bool later(const Entry& a, const Entry& b) { return a.expiresAt > b.expiresAt; }
+
+	std::vector<Entry> m_Heap;
+	std::array<std::vector<TimerEvent>, (size_t)TimerKind::Count> m_Expired;
+	// Milliseconds the scene has been simulated for, doubles stay exact to the ms for millennia
+	double m_Now = 0.0;
+	TimerId m_NextId = 1;
+};
@@ -0,0 +1,31 @@
+#include "timer_system.hpp"
+#include "entities/slingbro.hpp"
+#include "entities/projectile.hpp"
+#include "entities/helge_projectile.hpp"
+#include "entities/projectile_pool.hpp"
+
+void TimerSystem::step(ECS_ENTT::Scene* scene, float elapsed_ms)
+{
+	auto& registry = scene->m_Registry;
+	auto& timers = scene->m_Timers;
+	timers.advance(elapsed_ms);
+
+	for (const TimerEvent& event : timers.expired(TimerKind::Deformation))
+	{
+		auto* deformation = registry.valid(event.entity) ? registry.try_get<Deformation>(event.entity) : nullptr;
+		if (deformation && deformation->timer == event.id)
+			deformation->active = false;
+	}
+
+	for (const TimerEvent& event : timers.expired(TimerKind::ProjectileLifetime))
+	{
+		// Projectiles that came to rest or left the scene are already back in the pool
+		if (!registry.valid(event.entity) || registry.has<InactiveProjectile>(event.entity))
+			continue;
+		auto* projectile = registry.try_get<Projectile>(event.entity);
+		auto* helgeProjectile = registry.try_get<HelgeProjectile>(event.entity);
+		TimerId lifetime = projectile ? projectile->lifetime : helgeProjectile ? helgeProjectile->lifetime : 0;
+		if (lifetime == event.id)
+			ProjectilePool::release(ECS_ENTT::Entity(event.entity, scene));
+	}
+}
@@ -0,0 +1,12 @@
+#pragma once
+
+#include "Scene.h"
+
+// Runs the timed effects of a scene off its timer queue. Expiring an effect changes a field of its
+// component in place, so effects that come and go don't add and remove components all the time.
+class TimerSystem
+{
+public:
+	// Advances the scene's timers and applies the effects that expired, one kind at a time
+	static void step(ECS_ENTT::Scene* scene, float elapsed_ms);
+};
@@ -0,0 +1,144 @@
+#include "turn_journal.hpp"
+#include "loader/level_manager.hpp"
+
+#include "entities/slingbro.hpp"
+#include "entities/projectile_pool.hpp"
+
+void TurnJournal::clear()
+{
+	while (m_Count > 0)
+	{
+		newest().destroyedPowerUps.clear();
+		m_Head = (m_Head + TURN_JOURNAL_CAPACITY - 1) % TURN_JOURNAL_CAPACITY;
+		m_Count--;
+	}
+	m_Head = 0;
+}
+
+void TurnJournal::record(ECS_ENTT::Scene* scene, bool is_ai_turn)
+{
+	// Overwrite the oldest snapshot once the ring is full
+	TurnSnapshot& snapshot = m_Turns[m_Head];
+	m_Head = (m_Head + 1) % TURN_JOURNAL_CAPACITY;
+	m_Count = min(m_Count + 1, TURN_JOURNAL_CAPACITY);
+
+	snapshot.player = scene->GetPlayer();
+	snapshot.isAITurn = is_ai_turn;
+	snapshot.bros.clear();
+	snapshot.enemies.clear();
+	snapshot.destroyedPowerUps.clear();
+
+	auto& registry = scene->m_Registry;
+	for (auto entityID : registry.view<SlingBro>())
+	{
+		BroRecord record{ entityID, registry.get<Motion>(entityID), registry.get<Turn>(entityID), 1.f, -1, -1 };
+		if (auto* mass = registry.try_get<Mass>(entityID))
+			record.mass = mass->value;
+		if (auto* sizeChanged = registry.try_get<SizeChanged>(entityID))
+			record.sizeChangedTurnsRemaining = sizeChanged->turnsRemaining;
+		if (auto* massChanged = registry.try_get<MassChanged>(entityID))
+			record.massChangedTurnsRemaining = massChanged->turnsRemaining;
+		snapshot.bros.push_back(record);
+	}
+
+	for (auto entityID : registry.view<AI>())
+	{
+		const AI& ai = registry.get<AI>(entityID);
+		snapshot.enemies.push_back({ entityID, registry.get<Motion>(entityID), ai.countdown, ai.target });
+	}
+}
+
+void TurnJournal::record_destroyed_powerup(ECS_ENTT::Entity power_up, const std::string& type_key)
+{
+	if (m_Count == 0)
+		return;
+	newest().destroyedPowerUps.push_back({ type_key, power_up.GetComponent<Motion>() });
+}
+
+bool TurnJournal::rewind(ECS_ENTT::Scene* scene, bool current_turn_played, bool& is_ai_turn)
+{
+	// The newest snapshot is the start of the current turn, so skip past it if nothing happened yet
+	if (!current_turn_played)
+	{
+		if (m_Count < 2)
+			return false;
+		drop_newest(scene);
+	}
+	if (m_Count == 0)
+		return false;
+
+	TurnSnapshot& snapshot = newest();
+	restore_powerups(snapshot, scene);
+	apply(snapshot, scene);
+	is_ai_turn = snapshot.isAITurn;
+	return true;
+}
+
+TurnJournal::TurnSnapshot& TurnJournal::newest()
+{
+	assert(m_Count > 0);
+	return m_Turns[(m_Head + TURN_JOURNAL_CAPACITY - 1) % TURN_JOURNAL_CAPACITY];
+}
+
+void TurnJournal::drop_newest(ECS_ENTT::Scene* scene)
+{
+	// Power-ups picked up during the dropped turn have to come back too
+	restore_powerups(newest(), scene);
+	m_Head = (m_Head + TURN_JOURNAL_CAPACITY - 1) % TURN_JOURNAL_CAPACITY;
+	m_Count--;
+}
+
+void TurnJournal::restore_powerups(TurnSnapshot& snapshot, ECS_ENTT::Scene* scene)
+{
+	// Power-up resources are still cached, so recreating them doesn't touch the GPU
+	for (const auto& record : snapshot.destroyedPowerUps)
+	{
+		auto powerUp = LevelManager::create_entity(record.type, record.motion.position, scene);
+		powerUp.GetComponent<Motion>() = record.motion;
+	}
+	snapshot.destroyedPowerUps.clear();
+}
+
+void TurnJournal::apply(const TurnSnapshot& snapshot, ECS_ENTT::Scene* scene)
+{
+	auto& registry = scene->m_Registry;
+	scene->SetPlayer(snapshot.player);
+
+	for (const auto& record : snapshot.bros)
+	{
+		if (!registry.valid(record.id))
+			continue;
+
+		registry.get<Motion>(record.id) = record.motion;
+		registry.get<Turn>(record.id) = record.turn;
+		registry.get_or_emplace<Mass>(record.id).value = record.mass;
+		registry.get<SlingMotion>(record.id).isClicked = false;
+
+		if (record.sizeChangedTurnsRemaining >= 0)
+			registry.get_or_emplace<SizeChanged>(record.id).turnsRemaining = record.sizeChangedTurnsRemaining;
+		else
+			registry.remove_if_exists<SizeChanged>(record.id);
+
+		if (record.massChangedTurnsRemaining >= 0)
+			registry.get_or_emplace<MassChanged>(record.id).turnsRemaining = record.massChangedTurnsRemaining;
+		else
+			registry.remove_if_exists<MassChanged>(record.id);
+
+		if (auto* deformation = registry.try_get<Deformation>(record.id))
+			deformation->active = false;
+	}
+
+	for (const auto& record : snapshot.enemies)
+	{
+		if (!registry.valid(record.id))
+			continue;
+
+		registry.get<Motion>(record.id) = record.motion;
+		AI& ai = registry.get<AI>(record.id);
+		ai.countdown = record.countdown;
+		ai.target = record.target;
+	}
+
+	// Projectiles in flight belong to the turn being undone
+	ProjectilePool::releaseAll(scene);
+}
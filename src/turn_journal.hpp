@@ -0,0 +1,85 @@
+#pragma once
+
+#include "common.hpp"
+#include "Entity.h"
+#include "Scene.h"
+
+#include <array>
+#include <optional>
+#include <vector>
+
+// Fixed-size history of the dynamic state of a level at the start of each turn.
+// Only the state that changes between turns is recorded (bros, enemies and the
+// power-ups picked up during the turn), so a rewind never touches disk or the
+// renderer's resources. Once full, the oldest turn is overwritten.
+class TurnJournal
+{
+public:
+	// Forgets all recorded turns, e.g. when a level is (re)loaded
+	void clear();
+
+	// Records the state of the scene at the start of the current turn
+	void record(ECS_ENTT::Scene* scene, bool is_ai_turn);
+
+	// Remembers a power-up that is about to be destroyed so that rewinding can bring it back
+	void record_destroyed_powerup(ECS_ENTT::Entity power_up, const std::string& type_key);
+
+	// Restores the scene to the start of the current turn if it has already been played,
+	// otherwise to the start of the turn before it. Returns false if there is nothing to rewind to.
+	bool rewind(ECS_ENTT::Scene* scene, bool current_turn_played, bool& is_ai_turn);
+
+	size_t size() const { return m_Count; }
+
+private:
+	// Per-turn state of a sling bro, turns remaining is negative when the effect is not active
+	struct BroRecord
+	{
+		entt::entity id;
+		Motion motion;
+		Turn turn;
+		float mass;
+		int sizeChangedTurnsRemaining;
+		int massChangedTurnsRemaining;
+	};
+
+	struct EnemyRecord
+	{
+		entt::entity id;
+		Motion motion;
+		float countdown;
+		std::optional<vec2> target;
+	};
+
+	struct PowerUpRecord
+	{
+		std::string type;
+		Motion motion;
+	};
+
+	struct TurnSnapshot
+	{
+		unsigned int player = 0;
+		bool isAITurn = false;
+		std::vector<BroRecord> bros;
+		std::vector<EnemyRecord> enemies;
+
+		// Power-ups destroyed after this snapshot was taken
+		std::vector<PowerUpRecord> destroyedPowerUps;
+	};
+
+	TurnSnapshot& newest();
+
+	void drop_newest(ECS_ENTT::Scene* scene);
+
+	static void restore_powerups(TurnSnapshot& snapshot, ECS_ENTT::Scene* scene);
+
+	static void apply(const TurnSnapshot& snapshot, ECS_ENTT::Scene* scene);
+
+	// Snapshots are reused in place so their vectors keep their capacity between turns
+	std::array<TurnSnapshot, TURN_JOURNAL_CAPACITY> m_Turns;
+
+	// Index one past the newest snapshot
+	size_t m_Head = 0;
+
+	size_t m_Count = 0;
+};
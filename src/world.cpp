@@ -7,11 +7,17 @@
 #include "render_components.hpp"
 #include "animation.hpp" 
 #include "loader/level_manager.hpp"
+#include "loader/material_table.hpp"
+#include "loader/prefab_table.hpp"
+#include "turn_journal.hpp"
+#include "timer_system.hpp"
 
 #include <glm/ext/matrix_transform.hpp>
 
 // stlib
 #include <string.h>
+#include <algorithm>
+#include <cstdio>
 #include <cassert>
 #include <fstream>
 #include <iostream>
@@ -29,6 +35,7 @@
 #include "entities/slingbro.hpp"
 #include "entities/projectile.hpp"
 #include "entities/helge_projectile.hpp"
+#include "entities/projectile_pool.hpp"
 #include "entities/button.hpp"
 #include "entities/goal_tile.hpp"
 #include "entities/snail_enemy.hpp"
@@ -55,11 +62,27 @@ ECS_ENTT::Scene* WorldSystem::MenuScene = nullptr;
 ECS_ENTT::Scene* WorldSystem::HelpScene = nullptr;
 ECS_ENTT::Scene* WorldSystem::FinaleScene = nullptr;
 
-bool WorldSystem::is_ai_turn = true;
+GameInstance WorldSystem::Game;
+bool WorldSystem::turbo_mode = false;
 
 bool isLoadNextLevel = false;
 bool isLevelRestart = false;
 
+// State at the start of the most recent turns of the game scene
+TurnJournal turnJournal;
+
+// Game scene as its level was loaded, before the bros were spawned, so that
+// restarting the level neither reads it again nor recreates its tiles
+struct PristineLevel
+{
+	// Enemies and power-ups, restored like a saved game
+	SavedGame save;
+
+	// Every other entity of the level (tiles, background...), sorted
+	std::vector<entt::entity> kept;
+};
+std::optional<PristineLevel> pristineLevel;
+
 typedef ECS_ENTT::Entity (*fn)(vec3, ECS_ENTT::Scene*);
 const std::vector<fn> slingBroFunctions = { SlingBro::createOrangeSlingBro, SlingBro::createPinkSlingBro };
 
@@ -67,8 +90,9 @@ const std::vector<fn> slingBroFunctions = { SlingBro::createOrangeSlingBro, Slin
 // Note, this has a lot of OpenGL specific things, could be moved to the renderer; but it also defines the callbacks to the mouse and keyboard. That is why it is called here.
 WorldSystem::WorldSystem(ivec2 window_size_px)
 {
-	// Seeding rng with random device
-	rng = std::default_random_engine(std::random_device()());
+	// Seeding every random stream of the session from one master seed
+	Random::Init();
+	Game.random = Random::Stream();
 
 	///////////////////////////////////////
 	// Initialize GLFW
@@ -115,6 +139,10 @@ WorldSystem::WorldSystem(ivec2 window_size_px)
 	glfwSetCursorPosCallback(window, cursor_pos_redirect);
 	glfwSetMouseButtonCallback(window, cursor_click_redirect);
 
+	// Tile materials have to be known before their sounds can be loaded
+	MaterialTable::load(config_path(yaml_file(MATERIALS_FILE_NAME)));
+	PrefabTable::load(config_path(yaml_file(PREFABS_FILE_NAME)));
+
 	// Playing background music indefinitely
 	init_audio();
 	Mix_PlayMusic(background_music, -1);
@@ -176,16 +204,10 @@ WorldSystem::~WorldSystem()
 		Mix_FreeChunk(disabled_click_sound);
 	if (transport_sound != nullptr)
 		Mix_FreeChunk(transport_sound);
-	if (short_grass_sound != nullptr)
-		Mix_FreeChunk(short_grass_sound);
-	if (shorter_grass_sound != nullptr)
-		Mix_FreeChunk(shorter_grass_sound);
 	if (short_thud_sound != nullptr)
 		Mix_FreeChunk(short_thud_sound);
 	if (power_up_sound != nullptr)
 		Mix_FreeChunk(power_up_sound);
-	if (sizzle_sound != nullptr)
-		Mix_FreeChunk(sizzle_sound);
 	if (power_up_8bit_sound != nullptr)
 		Mix_FreeChunk(power_up_8bit_sound);
 	if (balloon_tap_sound != nullptr)
@@ -196,12 +218,9 @@ WorldSystem::~WorldSystem()
 		Mix_FreeChunk(squeak_sound);
 	if (short_monster_sound != nullptr)
 		Mix_FreeChunk(short_monster_sound);
-	if (sand_skidding_sound != nullptr)
-		Mix_FreeChunk(sand_skidding_sound);
-	if (tapping_glass_sound != nullptr)
-		Mix_FreeChunk(tapping_glass_sound);
-	if (snow_steppin_sound != nullptr)
-		Mix_FreeChunk(snow_steppin_sound);
+	for (auto sound : material_sounds)
+		if (sound != nullptr)
+			Mix_FreeChunk(sound);
 	Mix_CloseAudio();
 
 	// Free memory of all of the game's scenes
@@ -234,22 +253,24 @@ void WorldSystem::init_audio()
 	poppin_click_sound = Mix_LoadWAV(audio_path("poppin_click.wav").c_str());
 	disabled_click_sound = Mix_LoadWAV(audio_path("disabled_click.wav").c_str());
 	transport_sound = Mix_LoadWAV(audio_path("long_magic.wav").c_str());
-	short_grass_sound = Mix_LoadWAV(audio_path("short_grass.wav").c_str());
-	shorter_grass_sound = Mix_LoadWAV(audio_path("shorter_grass.wav").c_str());
 	short_thud_sound = Mix_LoadWAV(audio_path("slap.wav").c_str());
 	power_up_sound = Mix_LoadWAV(audio_path("power_up.wav").c_str());
-	sizzle_sound = Mix_LoadWAV(audio_path("sizzle.wav").c_str());
 	power_up_8bit_sound = Mix_LoadWAV(audio_path("power_up_8bit.wav").c_str());
 	balloon_tap_sound = Mix_LoadWAV(audio_path("balloon_tap.wav").c_str());
 	snail_monster_sound = Mix_LoadWAV(audio_path("snail_monster.wav").c_str());
 	squeak_sound = Mix_LoadWAV(audio_path("squeak.wav").c_str());
 	short_monster_sound = Mix_LoadWAV(audio_path("short_monster.wav").c_str());
-	sand_skidding_sound = Mix_LoadWAV(audio_path("skidding_sand.wav").c_str());
-	tapping_glass_sound = Mix_LoadWAV(audio_path("glass_tap.wav").c_str());
-	snow_steppin_sound = Mix_LoadWAV(audio_path("snow_steppin.wav").c_str());
-	Mix_VolumeChunk(sand_skidding_sound, 60);
-	Mix_VolumeChunk(tapping_glass_sound, 30);
-	Mix_VolumeChunk(snow_steppin_sound, 30);
+
+	material_sounds.assign(MaterialTable::size(), nullptr);
+	for (uint8_t id = 0; id < MaterialTable::size(); id++)
+	{
+		const MaterialProperties& material = MaterialTable::get(id);
+		if (material.sound.empty())
+			continue;
+		material_sounds[id] = Mix_LoadWAV(audio_path(material.sound).c_str());
+		if (material_sounds[id] != nullptr)
+			Mix_VolumeChunk(material_sounds[id], material.volume);
+	}
 }
 
 
@@ -274,52 +295,43 @@ ECS_ENTT::Scene* WorldSystem::FinaleInit()
 // Update our game world
 ECS_ENTT::Scene* WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_units)
 {
-	// Updating window title with points
-	std::stringstream title_ss;
-	title_ss << ActiveScene->m_Name;
+	// Updating window title with points. The title is formatted into a fixed buffer and only
+	// handed to GLFW when it changes, so a steady frame doesn't allocate
+	char turn_info[128] = "";
 	if (is_game_scene())
 	{
 		runWeatherCallbacks();
-		if (is_ai_turn) {
-			title_ss << " | Turn: Enemy";
+		if (Game.is_ai_turn) {
+			snprintf(turn_info, sizeof(turn_info), " | Turn: Enemy");
 		} else {
 			auto turn = get_current_player().GetComponent<Turn>();
 			auto countdown = ceil(turn.countdown / 100.f) / 10.f;
-			title_ss << " | Turn: Player " << ActiveScene->GetPlayer() << " (end turn in " << countdown << "s)" << " | Points: " << turn.points;
+			snprintf(turn_info, sizeof(turn_info), " | Turn: Player %u (end turn in %gs) | Points: %d",
+				ActiveScene->GetPlayer(), countdown, turn.points);
 		}
 	}
-	glfwSetWindowTitle(window, title_ss.str().c_str());
-
-	for (auto entityID : GameScene->m_Registry.view<PlayerProfile>())
+	char title[sizeof(window_title)];
+	snprintf(title, sizeof(title), "%s%s%s", ActiveScene->m_Name.c_str(), turn_info, is_game_scene() && turbo_mode ? " | Turbo" : "");
+	if (strcmp(title, window_title) != 0)
 	{
-		Text& text = GameScene->m_Registry.get<Text>(entityID);
-		auto profile = GameScene->m_Registry.get<PlayerProfile>(entityID);
-		int points = 0;
-		text.colour = { 0.f, 0.f, 0.f };
+		strcpy(window_title, title);
+		glfwSetWindowTitle(window, window_title);
+	}
 
-		switch (profile.broType)
+	// Profiles reference their bro, so the HUD doesn't have to look the bros up every frame
+	entt::entity current_bro = Game.is_ai_turn ? entt::entity{ entt::null } : GameScene->GetRosterEntity(GameScene->GetPlayer());
+	auto profiles = GameScene->m_Registry.view<PlayerProfile, Text>();
+	for (auto entityID : profiles)
+	{
+		auto [profile, text] = profiles.get<PlayerProfile, Text>(entityID);
+		int points = GameScene->m_Registry.get<Turn>(profile.bro).points;
+		text.colour = profile.bro == current_bro ? profile.highlightColour : vec3(0.f);
+		// Only rebuild the text when the points change
+		if (points != profile.shownPoints || text.content.empty())
 		{
-			case BroType::ORANGE:
-			{
-				auto orange = GameScene->m_Registry.view<OrangeBro>()[0];
-				points = GameScene->m_Registry.get<Turn>(orange).points;
-				if (!is_ai_turn && orange == get_current_player())
-				{
-					text.colour = { 0.87f, 0.48f, 0.17f };
-				}
-				break;
-			}
-			case BroType::PINK:
-			{
-				auto pink = GameScene->m_Registry.view<PinkBro>()[0];
-				points = GameScene->m_Registry.get<Turn>(pink).points;
-				if (!is_ai_turn && pink == get_current_player())
-				{
-					text.colour = { 1.f, 0.51f, 0.77f };
-				}
-			}
+			profile.shownPoints = points;
+			text.content = profile.playerName + ": " + std::to_string(points);
 		}
-		text.content = profile.playerName + ": " + std::to_string(points);
 	}
 
 	if (!ActiveScene->GetDialogueBoxNames().empty() && !ActiveScene->is_in_dialogue) {
@@ -349,37 +361,11 @@ ECS_ENTT::Scene* WorldSystem::step(float elapsed_ms, vec2 window_size_in_game_un
 		}
 	}
 
-	// TODO Removing out of screen entities (for the appropriate entities like projectiles, for example)
+	// Expire deformations, projectile lifetimes and the other timed effects
+	TimerSystem::step(ActiveScene, elapsed_ms);
 
-	// Tick all deformation component timers
-	auto deformationView = ActiveScene->m_Registry.view<Deformation>();
-	for (auto entityID : deformationView) {
-		ECS_ENTT::Entity deformedEntity = ECS_ENTT::Entity(entityID, WorldSystem::ActiveScene);
-		Deformation& deformation = deformedEntity.GetComponent<Deformation>();
-		deformation.timeRemaining -= elapsed_ms;
-		if (deformation.timeRemaining <= 0)
-			deformedEntity.RemoveComponent<Deformation>();
-	}
-
-	// Tick all projectile component timers
-	auto projectileView = ActiveScene->m_Registry.view<Projectile>();
-	for (auto entityID : projectileView) {
-		ECS_ENTT::Entity projectileEntity = ECS_ENTT::Entity(entityID, WorldSystem::ActiveScene);
-		Projectile& projectile = projectileEntity.GetComponent<Projectile>();
-		projectile.timeRemaining -= elapsed_ms;
-		if (projectile.timeRemaining <= 0)
-			ActiveScene->m_Registry.destroy(entityID);
-	}
-
-	// Tick all Helge projectile component timers
-	auto helgeProjectileView = ActiveScene->m_Registry.view<HelgeProjectile>();
-	for (auto entityID : helgeProjectileView) {
-		ECS_ENTT::Entity helgeProjectileEntity = ECS_ENTT::Entity(entityID, WorldSystem::ActiveScene);
-		HelgeProjectile& helgeProjectile = helgeProjectileEntity.GetComponent<HelgeProjectile>();
-		helgeProjectile.timeRemaining -= elapsed_ms;
-		if (helgeProjectile.timeRemaining <= 0)
-			ActiveScene->m_Registry.destroy(entityID);
-	}
+	// Return projectiles that came to rest or left the scene to the pool
+	ProjectilePool::step(ActiveScene);
 
 	return ActiveScene;
 }
@@ -390,19 +376,18 @@ void WorldSystem::update_projected_path(float elapsed_ms) {
 	if (slingBro.GetComponent<SlingMotion>().isClicked)
 	{
 		float minOpacity = 0.4;
-		for (auto& entity : ActiveScene->m_Registry.view<ProjectedPath>())
+		auto stars = ActiveScene->m_Registry.view<ProjectedPath, ShadedMeshRef, Motion>();
+		for (auto [entity, star, shader, motion] : stars.each())
 		{
-			auto star = ECS_ENTT::Entity(entity, GameScene);
-			auto& shader = star.GetComponent<ShadedMeshRef>();
 			float opacityShrinkScale = turn.path_fade_ms / PROJECTED_PATH_FADE_COUNTDOWN;
 
-			float scale = star.GetComponent<ProjectedPath>().scale;
+			float scale = star.scale;
 
 			shader.reference_to_cache->texture.color.w = opacityShrinkScale + minOpacity;
 			opacityShrinkScale = max(opacityShrinkScale, minOpacity);
-			star.GetComponent<Motion>().scale = { opacityShrinkScale * scale,
-												  opacityShrinkScale * scale,
-												  0 };
+			motion.scale = { opacityShrinkScale * scale,
+							 opacityShrinkScale * scale,
+							 0 };
 		}
 
 		// update countdown and path for projected path
@@ -424,7 +409,7 @@ void WorldSystem::handleDialogue() {
 	// Remove previous box
 	RemoveAllEntitiesWithComponent<DialogueBox>();
 
-	std::queue<std::string> dialogue_boxes = ActiveScene->GetDialogueBoxNames();
+	const std::queue<std::string>& dialogue_boxes = ActiveScene->GetDialogueBoxNames();
 	if (!dialogue_boxes.empty() && ActiveScene->is_in_dialogue) {
 		// Create new box
 		std::string current_box = dialogue_boxes.front();
@@ -474,15 +459,17 @@ void WorldSystem::remove_all_entities() {
 	GameScene->m_Registry.each([](const auto entityID, auto &&...) {
 		GameScene->m_Registry.destroy(entityID);
 	});
-	ParticleSystem::GetInstance()->clearBeeSwarms();
+	ParticleSystem::GetInstance()->clearBeeSwarms(GameScene);
+
+	// Nothing of the level is left to restart from
+	pristineLevel.reset();
 }
 
 template<typename ComponentType>
 void WorldSystem::RemoveAllEntitiesWithComponent()
 {
-	ActiveScene->m_Registry.view<ComponentType>().each([](const auto entityID, auto &&...) {
-		ActiveScene->m_Registry.destroy(entityID);
-	});
+	auto view = ActiveScene->m_Registry.view<ComponentType>();
+	ActiveScene->m_Registry.destroy(view.begin(), view.end());
 }
 
 bool WorldSystem::getIsLoadNextLevel() {
@@ -550,6 +537,13 @@ void WorldSystem::restart() // notes: like Game::init
 
 	ParticleSystem::GetInstance()->clearParticles();
 
+	// The level is put back from memory as it was loaded
+	if (is_game_scene() && pristineLevel)
+	{
+		restore_pristine_level();
+		return;
+	}
+
 	// Remove all old entities in the scene
 	remove_all_entities();
 
@@ -571,249 +565,8 @@ void WorldSystem::restart() // notes: like Game::init
 	}
 }
 
-void WorldSystem::powerup_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, ECS_ENTT::Scene* gameScene) {
-	Mix_PlayChannel(-1, power_up_sound, 0);
-
-	if (entity_j.HasComponent<SpeedPowerUp>()) {
-		SpeedPowerUp& speed_power_up = entity_j.GetComponent<SpeedPowerUp>();
-		speed_power_up.applyPowerUp(entity_i);
-	} else if (entity_j.HasComponent<SizeUpPowerUp>()) {
-		SizeUpPowerUp& size_up_power_up = entity_j.GetComponent<SizeUpPowerUp>();
-		size_up_power_up.applyPowerUp(entity_i);
-	} else if (entity_j.HasComponent<SizeDownPowerUp>()) {
-		SizeDownPowerUp& size_down_power_up = entity_j.GetComponent<SizeDownPowerUp>();
-		size_down_power_up.applyPowerUp(entity_i);
-	} else if (entity_j.HasComponent<CoinPowerUp>()) {
-		CoinPowerUp& coin_power_up = entity_j.GetComponent<CoinPowerUp>();
-		coin_power_up.applyPowerUp(entity_i);
-	} else if (entity_j.HasComponent<MassUpPowerUp>()) {
-		MassUpPowerUp& mass_up_power_up = entity_j.GetComponent<MassUpPowerUp>();
-		mass_up_power_up.applyPowerUp(entity_i);
-	}
-
-	gameScene->m_Registry.destroy(entity_j);
-}
-
-void WorldSystem::collidable_enemy_collision_listener(ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity enemyEntity)
-{
-	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
-	Motion& enemyMotion = enemyEntity.GetComponent<Motion>();
-
-	// Don't count collisions when it is the enemy's turn
-	if (is_ai_turn)
-		return;
-
-	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
-	collidingBrosTurn.subPoints(POINTS_LOST_UPON_ENEMY_COLLISION);
-
-	// Knock the player away from the enemy and emit a "blood spray" particle effect 
-	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(enemyMotion.position - slingBroMotion.position));
-	slingBroMotion.position -= 5.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	auto& broVelocity = slingBroMotion.velocity;
-	float broSpeed = glm::length(broVelocity);
-	broVelocity = broSpeed * -glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	broVelocity.x += (0.5f - Random::Float()) * MAX_VELOCITY / 2.0f;
-	if (broSpeed > MAX_VELOCITY)
-		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
-
-	// Check orientation of character from the enemy and set knockback direction, particle velocity, & deformations correctly
-	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from spike tile to slingbro
-	glm::vec3 particleVelocity = glm::vec3(1.0f);
-	float particleSpeed = 0.1f;
-	if (angle > -PI / 4 && angle <= PI / 4) // bro to the right 
-		particleVelocity = glm::vec3(-particleSpeed, 0.0f, 0.0f);
-	else if (angle > PI / 4 && angle <= 3 * PI / 4)	// bro below 
-		particleVelocity = glm::vec3(0.0f, -particleSpeed, 0.0f);
-	else if (angle > 3 * PI / 4 && angle <= 5 * PI / 4)	// bro to the left 
-		particleVelocity = glm::vec3(particleSpeed, 0.0f, 0.0f);
-	else // bro above 
-		particleVelocity = glm::vec3(0.0f, particleSpeed, 0.0f);
-
-	// Deform the bro
-	if (!slingBroEntity.HasComponent<Deformation>())
-		slingBroEntity.AddComponent<Deformation>(0.8f, 1.2f, angle, 100.0f);
-	Mix_PlayChannel(-1, ugh_sound, 0);
-
-	// Emit blood spray particles
-	ParticleSystem* particleSystem = ParticleSystem::GetInstance();
-	ParticleProperties particle;
-	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
-	particle.position = slingBroMotion.position; +glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
-	particle.velocity = broVelocity / (100.0f * broSpeed);
-	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
-	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
-	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
-	particle.sizeBegin = 8.0f;
-	particle.sizeEnd = 0.1f;
-	particle.sizeVariation = 2.0f;
-	particle.lifeTimeMs = 2000.0f;
-	for (int i = 0; i < 100; i++)
-		particleSystem->Emit(particle);
-}
-
-void WorldSystem::ground_spike_collision_listener(ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity groundSpikeEntity)
-{
-	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
-	Motion& groundSpikeMotion = groundSpikeEntity.GetComponent<Motion>();
-
-	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
-	collidingBrosTurn.subPoints(POINTS_LOST_UPON_SPIKE_COLLISION);
-
-	// Knock the player away from the spike and emit a "blood spray" particle effect 
-	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(groundSpikeMotion.position - slingBroMotion.position));
-	slingBroMotion.position -= 1.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	auto& broVelocity = slingBroMotion.velocity;
-	float broSpeed = glm::length(broVelocity);
-	if (broVelocity.y > 0.0f)
-		broVelocity.y *= -1.0f - (Random::Float() / 2.0f);
-	broVelocity.x *= -1.0f + ((0.5f - Random::Float()) / 2.0f);
-	if (abs(broVelocity.x) < 200.0f)
-		broVelocity.x += (0.5f - Random::Float()) * 1.5f * glm::length(broVelocity);
-	if (broSpeed > MAX_VELOCITY)
-		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
-
-	// Deform the character
-	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from ground spike to slingbro
-	if (!slingBroEntity.HasComponent<Deformation>())
-		slingBroEntity.AddComponent<Deformation>(0.8f, 1.2f, angle, 100.0f);
-	Mix_PlayChannel(-1, ugh_sound, 0);
-
-	// Emit blood spray particles
-	ParticleSystem* particleSystem = ParticleSystem::GetInstance();
-	ParticleProperties particle;
-	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
-	particle.position = slingBroMotion.position + glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
-	particle.velocity = glm::vec3(0.0f, -0.05f, 0.0f);
-	particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f) / 2.0f;
-	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
-	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
-	particle.sizeBegin = 8.0f;
-	particle.sizeEnd = 4.0f;
-	particle.sizeVariation = 2.0f;
-	particle.lifeTimeMs = 4000.0f;
-	for (int i = 0; i < 20; i++)
-		particleSystem->Emit(particle);
-	particle.velocity = broVelocity / (10.0f * broSpeed);
-	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
-	for (int i = 0; i < 80; i++)
-		particleSystem->Emit(particle);
-}
-
-void WorldSystem::tile_spike_collision_listener(ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity tileSpikeEntity)
-{
-	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
-	Motion& tileSpikeMotion = tileSpikeEntity.GetComponent<Motion>();
-
-	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
-	collidingBrosTurn.subPoints(POINTS_LOST_UPON_SPIKE_COLLISION);
-
-	// Knock the player away from the spike tile and emit a "blood spray" particle effect 
-	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(tileSpikeMotion.position - slingBroMotion.position));
-	slingBroMotion.position += 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	auto& broVelocity = slingBroMotion.velocity;
-	float broSpeed = glm::length(broVelocity);
-	broVelocity = broSpeed * -glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	broVelocity.x += (0.5f - Random::Float()) * MAX_VELOCITY / 2.0f;
-	if (broSpeed > MAX_VELOCITY)
-		broVelocity = (broVelocity / broSpeed) * MAX_VELOCITY;
-
-	// Check orientation of character from the spike tile and set knockback direction, particle velocity correctly
-	float angle = atan(dispVecNorm.y, dispVecNorm.x); // angle in radians from spike tile to slingbro
-	glm::vec3 particleVelocity = glm::vec3(1.0f);
-	float particleSpeed = 0.1f;
-	if (angle > -PI / 4 && angle <= PI / 4) // bro to the right of spike tile
-		particleVelocity = glm::vec3(-particleSpeed, 0.0f, 0.0f);
-	else if (angle > PI / 4 && angle <= 3 * PI / 4)	// bro below spike tile
-		particleVelocity = glm::vec3(0.0f, -particleSpeed, 0.0f);
-	else if (angle > 3 * PI / 4 && angle <= 5 * PI / 4)	// bro to the left of spike tile
-		particleVelocity = glm::vec3(particleSpeed, 0.0f, 0.0f);
-	else // bro above spike tile
-		particleVelocity = glm::vec3(0.0f, particleSpeed, 0.0f);
-
-	// Deform the character
-	if (!slingBroEntity.HasComponent<Deformation>())
-		slingBroEntity.AddComponent<Deformation>(0.8f, 1.2f, angle, 100.0f);
-	Mix_PlayChannel(-1, ugh_sound, 0);
-
-	// Emit blood spray particles
-	ParticleSystem* particleSystem = ParticleSystem::GetInstance();
-	ParticleProperties particle;
-	glm::vec2 particleOffset = glm::vec2(dispVecNorm.x * (slingBroMotion.scale.x / 1.4f), dispVecNorm.y * (slingBroMotion.scale.y / 1.4f));
-	particle.position = slingBroMotion.position + glm::vec3(particleOffset.x, particleOffset.y, 0.0f);
-	particle.velocity = particleVelocity;
-	particle.velocityVariation = glm::vec3(0.2f, 0.125f, 0.2f) / 2.0f;
-	particle.colourBegin = glm::vec4(0.9f, 0.1f, 0.1f, 1.0f);
-	particle.colourEnd = glm::vec4(0.5f, 0.0f, 0.0f, 0.0f);
-	particle.sizeBegin = 8.0f;
-	particle.sizeEnd = 4.0f;
-	particle.sizeVariation = 2.0f;
-	particle.lifeTimeMs = 4000.0f;
-	for (int i = 0; i < 20; i++)
-		particleSystem->Emit(particle);
-	particle.velocity = broVelocity / (10.0f * broSpeed);
-	particle.velocityVariation = glm::vec3(0.25f, 0.1f, 0.2f);
-	for (int i = 0; i < 80; i++)
-		particleSystem->Emit(particle);
-}
-
-void WorldSystem::projectile_collision_listener(ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity projectileEntity)
-{
-	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
-	Motion& projectileMotion = projectileEntity.GetComponent<Motion>();
-
-	auto& collidingBrosTurn = slingBroEntity.GetComponent<Turn>();
-	collidingBrosTurn.subPoints(POINTS_LOST_BASIC_PROJECTILE);
-	ActiveScene->m_Registry.destroy(projectileEntity);
-
-	// Knock the player away from the projectile
-	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(projectileMotion.position - slingBroMotion.position));
-	slingBroMotion.position -= 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	auto& broVelocity = slingBroMotion.velocity;
-	auto& projectileVelocity = projectileMotion.velocity;
-	float broSpeed = glm::length(broVelocity);
-	float projectileSpeed = glm::length(projectileVelocity);
-	broVelocity = (broSpeed + projectileSpeed) * -2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-
-	if (broSpeed > MAX_PROJECTILE_KNOCKBACK_VELOCITY)
-		broVelocity = (broVelocity / broSpeed) * MAX_PROJECTILE_KNOCKBACK_VELOCITY;
-
-	// Deform the character
-	float angle = atan(dispVecNorm.y, dispVecNorm.x);
-	if (!slingBroEntity.HasComponent<Deformation>())
-		slingBroEntity.AddComponent<Deformation>(0.8f, 1.2f, angle, 100.0f);
-	Mix_PlayChannel(-1, ugh_sound, 0);
-}
-
-void WorldSystem::helge_projectile_collision_listener(ECS_ENTT::Entity slingBroEntity, ECS_ENTT::Entity helgeProjectileEntity)
-{
-	Motion& slingBroMotion = slingBroEntity.GetComponent<Motion>();
-	Motion& helgeProjectileMotion = helgeProjectileEntity.GetComponent<Motion>();
-
-	auto& turn = slingBroEntity.GetComponent<Turn>();
-	turn.subPoints(POINTS_LOST_HELGE_PROJECTILE);
-	ActiveScene->m_Registry.destroy(helgeProjectileEntity);
-
-	// Knock the player away from Helge's projectile 
-	glm::vec2 dispVecNorm = glm::vec2(glm::normalize(helgeProjectileMotion.position - slingBroMotion.position));
-	slingBroMotion.position -= 2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-	auto& broVelocity = slingBroMotion.velocity;
-	auto& projectileVelocity = helgeProjectileMotion.velocity;
-	float broSpeed = glm::length(broVelocity);
-	float projectileSpeed = glm::length(projectileVelocity);
-	broVelocity = (broSpeed + projectileSpeed) * -2.0f * glm::vec3(dispVecNorm.x, dispVecNorm.y, 0.0f);
-
-	if (broSpeed > MAX_PROJECTILE_KNOCKBACK_VELOCITY)
-		broVelocity = (broVelocity / broSpeed) * MAX_PROJECTILE_KNOCKBACK_VELOCITY;
-
-	// Deform the character
-	float angle = atan(dispVecNorm.y, dispVecNorm.x);
-	if (!slingBroEntity.HasComponent<Deformation>())
-		slingBroEntity.AddComponent<Deformation>(0.6f, 1.4f, angle, 100.0f);
-	Mix_PlayChannel(-1, ugh_sound, 0);
-}
-
 // Collisions between wall and non-wall entities - callback function, listening to PhysicsSystem::Collisions
-// example of observer pattern
+// example of observer pattern. The rules themselves are in the GameplaySystem, see game_event_listener
 void WorldSystem::collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall)
 {
 	if (!is_game_scene()) return;
@@ -821,69 +574,42 @@ void WorldSystem::collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity
 	if (entity_i.HasComponent<SlingBro>() && DebugSystem::in_debug_mode) {
 		DebugSystem::in_freeze_mode = true;
 	}
+}
 
-	auto current_player = get_current_player();
+void WorldSystem::game_event_listener(GameEvent event, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall)
+{
+	if (!is_game_scene()) return;
 
-	if (!hit_wall && entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<Projectile>()) {
-		projectile_collision_listener(entity_i, entity_j);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HelgeProjectile>()) {
-		helge_projectile_collision_listener(entity_i, entity_j);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HazardSpike>()) {
-		ground_spike_collision_listener(entity_i, entity_j);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<HazardTileSpike>()) {
-		tile_spike_collision_listener(entity_i, entity_j);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<CollidableEnemy>()) {
-		collidable_enemy_collision_listener(entity_i, entity_j);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<SlingBro>()) {
-		Mix_PlayChannel(-1, ugh_sound, 0);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<PowerUp>()) {
-		powerup_collision_listener(entity_i, entity_j, ActiveScene);
-	}
-	else if (entity_i.HasComponent<SlingBro>() && entity_j.HasComponent<GoalTile>())
+	switch (event)
 	{
+	case GAME_EVENT_BRO_HURT:
+	case GAME_EVENT_BROS_BUMPED:
+		Mix_PlayChannel(-1, ugh_sound, 0);
+		break;
+	case GAME_EVENT_POWER_UP_TAKEN:
+		Mix_PlayChannel(-1, power_up_sound, 0);
+		turnJournal.record_destroyed_powerup(entity_j, LevelManager::to_type_key(entity_j));
+		break;
+	case GAME_EVENT_GOAL_REACHED:
 		Mix_PlayChannel(-1, transport_sound, 0);
 		Mix_PlayChannel(-1, yeehaw_sound, 0);
 		setIsLoadNextLevel(true);
-	}
-	else if (entity_i.HasComponent<SnailEnemy>() && entity_j.HasComponent<GoalTile>())
-	{
+		break;
+	case GAME_EVENT_SNAIL_REACHED_GOAL:
 		setIsLevelRestart(true);
-	}
-	else if (is_moving(current_player) && entity_i == current_player)
+		break;
+	case GAME_EVENT_CONTACT:
 	{
 		// slingBro sound effects for tiles
-		if (entity_i.HasComponent<SlingBro>())
+		auto current_player = get_current_player();
+		if (is_moving(current_player) && entity_i == current_player && entity_i.HasComponent<SlingBro>())
 		{
 			if (abs(entity_i.GetComponent<Motion>().velocity.y) > AUDIO_TRIGGER_VELOCITY_Y) {
-				if (entity_j.HasComponent<WindyGrass>())
-				{
-					Mix_PlayChannel(-1, short_grass_sound, 0);
-				}
-				else if (entity_j.HasComponent<GrassyTile>())
-				{
-					Mix_PlayChannel(-1, shorter_grass_sound, 0);
-				}
-				else if (entity_j.HasComponent<LavaTile>())
-				{
-					Mix_PlayChannel(-1, sizzle_sound, 0);
-				}
-				else if (entity_j.HasComponent<SandTile>())
-				{
-					Mix_PlayChannel(-1, sand_skidding_sound, 0);
-				}
-				else if (entity_j.HasComponent<GlassTile>())
-				{
-					Mix_PlayChannel(-1, tapping_glass_sound, 0);
-				}
-				else if (entity_j.HasComponent<BouncyTile>())
+				if (entity_j.HasComponent<Material>())
 				{
-				Mix_PlayChannel(-1, snow_steppin_sound, 0);
+					Mix_Chunk* sound = material_sounds[entity_j.GetComponent<Material>().id];
+					if (sound != nullptr)
+						Mix_PlayChannel(-1, sound, 0);
 				}
 				else if (hit_wall)
 				{
@@ -891,6 +617,8 @@ void WorldSystem::collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity
 				}
 			}
 		}
+		break;
+	}
 	}
 }
 
@@ -998,6 +726,18 @@ void WorldSystem::on_key(int key, int, int action, int mod)
 			{
 				load_saved_level();
 			}
+
+			// Rewind the last turn
+			if (key == GLFW_KEY_U)
+			{
+				rewind_turn();
+			}
+
+			// Fast forward enemy turns and settling bros
+			if (key == GLFW_KEY_T)
+			{
+				turbo_mode = !turbo_mode;
+			}
 			
 			// Return to main menu
 			if (key == GLFW_KEY_ESCAPE)
@@ -1071,16 +811,13 @@ void WorldSystem::on_mouse_move(vec2 mouse_pos)
 		}
 
 		// Rotate the bro
-		if (!is_ai_turn && !ActiveScene->is_in_dialogue)
+		if (!Game.is_ai_turn && !ActiveScene->is_in_dialogue)
 		{
-			if (!slingBro.HasComponent<DeathTimer>())
-			{
-				auto& m_slingbro = slingBro.GetComponent<Motion>();
-				glm::vec2 dispVecFromBro = getDispVecFromSource(glm::vec2(mouse_pos), glm::vec3(m_slingbro.position));
-				float angle = atan2(dispVecFromBro.y, dispVecFromBro.x);
-				// Offset angle by pi/2 to correct rotation angle
-				m_slingbro.angle = angle + M_PI_2;
-			}
+			auto& m_slingbro = slingBro.GetComponent<Motion>();
+			glm::vec2 dispVecFromBro = getDispVecFromSource(glm::vec2(mouse_pos), glm::vec3(m_slingbro.position));
+			float angle = atan2(dispVecFromBro.y, dispVecFromBro.x);
+			// Offset angle by pi/2 to correct rotation angle
+			m_slingbro.angle = angle + M_PI_2;
 		}
 	}
 
@@ -1126,7 +863,7 @@ void WorldSystem::on_mouse_click(int button, int action, int mods)
 
 				if (abs(dispVecFromBro.x) < broMotion.scale.x && abs(dispVecFromBro.y) < broMotion.scale.y && canClick && !turn.slung)
 				{
-					isBroClicked = !WorldSystem::is_ai_turn;
+					isBroClicked = !WorldSystem::Game.is_ai_turn;
 				}
 			}
 
@@ -1162,6 +899,7 @@ void WorldSystem::on_mouse_click(int button, int action, int mods)
 
 				// Record that player has slung
 				turn.slung = true;
+				slingbro.GetComponent<Sleep>().wake();
 			}
 		}
 	}
@@ -1401,7 +1139,8 @@ void WorldSystem::spawn_players() {
 		float x = m_tile.position.x + offset * i;
 		float y = m_tile.position.y + offset;
 		float z = 4.f * (i + 1); // Z-fighting
-		const auto& create_slingBro = slingBroFunctions.at(curr_player);
+		// Party levels with more bros than bro types reuse the types in turn
+		const auto& create_slingBro = slingBroFunctions[curr_player % slingBroFunctions.size()];
 		auto bro = (*create_slingBro)(glm::vec3(x, y, z), WorldSystem::GameScene);
 
 		// Set the turn order of the player where
@@ -1418,23 +1157,8 @@ void WorldSystem::point_camera_at_current_player() {
 
 ECS_ENTT::Entity WorldSystem::get_current_player() {
 	// Game scene must have the expected number of players
-	auto slingbros_view = GameScene->m_Registry.view<SlingBro>();
-	assert(slingbros_view.size() == GameScene->GetNumPlayers());
-
-	// Find the player with the current player index
-	auto player_idx = GameScene->GetPlayer();
-	for (auto slingbro_id : slingbros_view)
-	{
-		auto player = ECS_ENTT::Entity(slingbro_id, WorldSystem::GameScene);
-		if (player.GetComponent<Turn>().order == player_idx)
-		{
-			return player;
-		}
-	}
-
-	// Fallback to assume view order is same as initial scene
-	// render order, which is not true so I hope we don't get here
-	return ECS_ENTT::Entity(slingbros_view[player_idx], WorldSystem::GameScene);
+	assert(GameScene->GetRoster().size() == GameScene->GetNumPlayers());
+	return ECS_ENTT::Entity(GameScene->GetRosterEntity(GameScene->GetPlayer()), WorldSystem::GameScene);
 }
 
 bool WorldSystem::should_end_turn(float elapsed_ms) {
@@ -1449,7 +1173,10 @@ bool WorldSystem::should_end_turn(float elapsed_ms) {
 	// Don't end the player's turn if they have yet to sling
 	if (!turn.slung)
 		return false;
-	
+
+	// The physics system puts bros to sleep once they have come to rest
+	if (current_player.GetComponent<Sleep>().asleep)
+		return true;
 
 	// Check if velocity within threshold, i.e. close to halt
 	if (is_moving(current_player))
@@ -1464,6 +1191,22 @@ bool WorldSystem::should_end_turn(float elapsed_ms) {
 	return turn.countdown <= 0.f;
 }
 
+bool WorldSystem::is_fast_forwarding()
+{
+	if (!turbo_mode || !is_game_scene() || ActiveScene->is_in_dialogue)
+		return false;
+
+	// Nothing can be done until the enemies are done or the slung bro has settled
+	return Game.is_ai_turn || get_current_player().GetComponent<Turn>().slung;
+}
+
+bool WorldSystem::is_settled()
+{
+	if (!is_game_scene() || ActiveScene->is_in_dialogue || Game.is_ai_turn)
+		return false;
+	return !get_current_player().GetComponent<Turn>().slung;
+}
+
 void WorldSystem::save_turn_point_information(std::vector<int>* arr) {
 	for (auto entityId : ActiveScene->m_Registry.view<Turn>()) {
 		auto turn = ActiveScene->m_Registry.get<Turn>(entityId);
@@ -1499,7 +1242,7 @@ unsigned int WorldSystem::set_next_player() {
 
 	// Increment player index to next player
 	auto next_player_idx = (GameScene->GetPlayer() + 1) % GameScene->GetNumPlayers();
-	WorldSystem::is_ai_turn = next_player_idx == 0 && !GameScene->m_Registry.view<AI>().empty();
+	WorldSystem::Game.is_ai_turn = next_player_idx == 0 && !GameScene->m_Registry.view<AI>().empty();
 	GameScene->SetPlayer(next_player_idx);
 
 	// Get new player's turn and reset their pointsLostThisTurn to zero
@@ -1509,31 +1252,57 @@ unsigned int WorldSystem::set_next_player() {
 	// Take away points for every bee swarm targeting the current player
 	decrement_points_bee_swarm();
 	
-//	if (WorldSystem::is_ai_turn)
+//	if (WorldSystem::Game.is_ai_turn)
 //	{
 //		Mix_PlayChannel(-1, short_monster_sound, 0);
 //	}
 
+	// Remember the start of the new turn so it can be rewound to
+	turnJournal.record(GameScene, WorldSystem::Game.is_ai_turn);
+
 	// Pan camera to next player
 	point_camera_at_current_player();
 	return next_player_idx;
 }
 
+void WorldSystem::rewind_turn()
+{
+	// An enemy turn is skipped over rather than replayed
+	bool current_turn_played = !Game.is_ai_turn && get_current_player().GetComponent<Turn>().slung;
+	if (!turnJournal.rewind(GameScene, current_turn_played, WorldSystem::Game.is_ai_turn))
+		return;
+
+	printf("Rewound to the start of player %u's turn\n", GameScene->GetPlayer());
+	RemoveAllEntitiesWithComponent<ProjectedPath>();
+	point_camera_at_current_player();
+}
+
 void WorldSystem::load_level(const std::string& level_file_path, size_t num_players_to_spawn)
 {
 	// Check if level exists
 	assert(Util::file_exists(level_file_path) && "HAVE YOU CREATED THE LEVEL AND COPIED IT INTO THE levels/ DIRECTORY HUH????\n");
 
-	// Grab old scene values and delete
+	// Grab old scene values and delete, the new scene gets a copy of the camera
 	auto next_player_idx = GameScene->GetPlayer();
 	Camera* oldCamera = new Camera(*WorldSystem::GameScene->GetCamera());
-	delete(WorldSystem::GameScene);
+	unload_game_scene();
 
 	// Load the level
 	printf("Loading level from '%s'\n", level_file_path.c_str());
 	WorldSystem::GameScene = LevelManager::load_level(level_file_path, oldCamera);
 	GameScene->SetPlayer(next_player_idx);
 
+	// Everything but the level's dynamic entities is kept when restarting
+	auto& registry = GameScene->m_Registry;
+	auto dynamic = registry.view<Motion>(entt::exclude<IgnorePhysics, IgnoreSave>);
+	pristineLevel.emplace();
+	pristineLevel->save = LevelManager::snapshot(GameScene);
+	registry.each([&dynamic](entt::entity entityID) {
+		if (!dynamic.contains(entityID))
+			pristineLevel->kept.push_back(entityID);
+	});
+	std::sort(pristineLevel->kept.begin(), pristineLevel->kept.end());
+
 	// Spawn the players
 	if (num_players_to_spawn > 0)
 	{
@@ -1541,48 +1310,106 @@ void WorldSystem::load_level(const std::string& level_file_path, size_t num_play
 		WorldSystem::spawn_players();
 	}
 
+	enter_game_scene();
+	play_scene_music();
+}
 
-	for (auto entityID : GameScene->m_Registry.view<SlingBro>())
-	{
-		auto player = ECS_ENTT::Entity(entityID, GameScene);
+void WorldSystem::restore_pristine_level()
+{
+	auto& registry = GameScene->m_Registry;
+	ParticleSystem::GetInstance()->clearBeeSwarms(GameScene);
+	ProjectilePool::releaseAll(GameScene);
+
+	// Remove what the level didn't start with, e.g. the bros and the HUD. Tile chunks are
+	// built from tiles that never change and pooled projectiles are reused, so they stay.
+	std::vector<entt::entity> removed;
+	const auto& kept = pristineLevel->kept;
+	registry.each([&](entt::entity entityID) {
+		if (registry.has<TileChunk>(entityID) || registry.has<InactiveProjectile>(entityID))
+			return;
+		if (!std::binary_search(kept.begin(), kept.end(), entityID))
+			removed.push_back(entityID);
+	});
+	registry.destroy(removed.begin(), removed.end());
 
-		std::shared_ptr<TextFont> font = TextFont::load(RETRO_COMPUTER_TTF);
+	// Same turn order as reloading the level would give
+	auto next_player_idx = GameScene->GetPlayer();
+	auto num_players = GameScene->GetNumPlayers();
+	LevelManager::restore(pristineLevel->save, GameScene);
+	GameScene->is_in_dialogue = false;
+	GameScene->current_dialogue_box = "";
+	GameScene->SetPlayer(next_player_idx);
+	GameScene->SetNumPlayer(num_players);
+	spawn_players();
 
-		// sorry for hardcoding T_T but there's only 2 of em
-		if (player.HasComponent<OrangeBro>())
-		{
-			auto bro = SlingBro::createOrangeSlingBroProfile(glm::vec3(30, 20, 0), WorldSystem::GameScene);
-			Text& playerTextComponent = bro.GetComponent<Text>();
-			playerTextComponent.font = font;
-			playerTextComponent.scale = TEXT_SCALE;
-			playerTextComponent.position = vec2(TEXT_DISTANCE_X, TEXT_DISTANCE_Y);
-		}
-		else
-		{
-			auto bro = SlingBro::createPinkSlingBroProfile(glm::vec3(30, 20, 0), WorldSystem::GameScene);
-			Text& playerTextComponent = bro.GetComponent<Text>();
-			playerTextComponent.font = font;
-			playerTextComponent.scale = TEXT_SCALE;
-			playerTextComponent.position = vec2(TEXT_DISTANCE_X, TEXT_DISTANCE_Y * 2);
-		}
-	}
+	// The level's music keeps playing
+	enter_game_scene();
+}
+
+void WorldSystem::unload_game_scene()
+{
+	// Swarms live in the scene's entity pool, so they go with it
+	ParticleSystem::GetInstance()->clearBeeSwarms(GameScene);
+
+#ifdef SLINGBROS_TRACK_ALLOCATIONS
+	// Reported along with the heap allocations, see src/alloc_tracker.hpp
+	LevelArena* arena = GameScene->GetArena();
+	printf("Unloading '%s', releasing %lu bytes from %lu allocations\n", GameScene->m_Name.c_str(),
+		(unsigned long)arena->GetBytesAllocated(), (unsigned long)arena->GetNumAllocations());
+#endif
+	delete GameScene;
+	GameScene = nullptr;
+	pristineLevel.reset();
+}
+
+void WorldSystem::enter_game_scene()
+{
+	// A new level, nobody has won or lost it yet
+	WorldSystem::Game.result = GAME_RESULT_NONE;
+
+	// Turns from the previous scene can't be rewound to
+	turnJournal.clear();
+	turnJournal.record(GameScene, WorldSystem::Game.is_ai_turn);
 
+	// Show a profile for each bro, listed in turn order
+	std::shared_ptr<TextFont> font = TextFont::load(RETRO_COMPUTER_TTF);
+	const auto& roster = GameScene->GetRoster();
+	for (unsigned int order = 0; order < roster.size(); order++)
+	{
+		auto player = ECS_ENTT::Entity(roster[order], GameScene);
+		auto bro = player.HasComponent<OrangeBro>()
+			? SlingBro::createOrangeSlingBroProfile(glm::vec3(30, 20, 0), WorldSystem::GameScene)
+			: SlingBro::createPinkSlingBroProfile(glm::vec3(30, 20, 0), WorldSystem::GameScene);
+
+		auto& profile = bro.GetComponent<PlayerProfile>();
+		profile.bro = roster[order];
+		if (order >= slingBroFunctions.size())
+			profile.playerName += " " + std::to_string(order + 1);
+
+		Text& playerTextComponent = bro.GetComponent<Text>();
+		playerTextComponent.font = font;
+		playerTextComponent.scale = TEXT_SCALE;
+		playerTextComponent.position = vec2(TEXT_DISTANCE_X, TEXT_DISTANCE_Y * (order + 1));
+	}
 
 	// Pan camera to next player
 	point_camera_at_current_player();
 
-	// Play music
-	background_music = Mix_LoadMUS(audio_path(WorldSystem::GameScene->m_BackgroundMusicFileName).c_str());
-	Mix_PlayMusic(background_music, -1);
-
 	// Switch to game scene
 	WorldSystem::ActiveScene = WorldSystem::GameScene;
 
 	// create title text
-	std::shared_ptr<TextFont> font = TextFont::load(RETRO_COMPUTER_TTF);
 	createText("texty", GameScene->m_Name, {30, 770}, font, 0.5f);
 }
 
+void WorldSystem::play_scene_music()
+{
+	// Play music, freeing the previous level's
+	Mix_FreeMusic(background_music);
+	background_music = Mix_LoadMUS(audio_path(WorldSystem::GameScene->m_BackgroundMusicFileName).c_str());
+	Mix_PlayMusic(background_music, -1);
+}
+
 ECS_ENTT::Entity WorldSystem::createText(std::string name, std::string content, vec2 position, std::shared_ptr<TextFont> font, float scale)
 {
 	ECS_ENTT::Entity texty = GameScene->CreateEntity(name);
@@ -1599,15 +1426,26 @@ ECS_ENTT::Entity WorldSystem::createText(std::string name, std::string content,
 bool WorldSystem::load_saved_level()
 {
 	// Check if user has saved level progress
-	const std::string saved_file_path = saved_path(yaml_file(SAVE_FILE_NAME));
+	const std::string saved_file_path = saved_path(save_file(SAVE_FILE_NAME));
 	if (!Util::file_exists(saved_file_path))
 	{
 		return false;
 	}
 
-	// Load the saved level file
+	// Load the level the save refers to along with the saved progress
 	printf("Found saved data at '%s'\n", saved_file_path.c_str());
-	load_level(saved_file_path, 0);
+	Camera* oldCamera = new Camera(*WorldSystem::GameScene->GetCamera());
+	ECS_ENTT::Scene* savedScene = LevelManager::load_saved_game(saved_file_path, oldCamera);
+	if (savedScene == nullptr)
+	{
+		delete oldCamera;
+		return false;
+	}
+
+	unload_game_scene();
+	WorldSystem::GameScene = savedScene;
+	enter_game_scene();
+	play_scene_music();
 	return true;
 }
 
@@ -1681,7 +1519,7 @@ void WorldSystem::attach(std::function<void(ECS_ENTT::Scene* scene)> fn)
 
 void WorldSystem::runWeatherCallbacks()
 {
-	for (std::function<void(ECS_ENTT::Scene* scene)> fn : callbacks) {
+	for (const auto& fn : callbacks) {
 		// run the callback functions
 		fn(ActiveScene);
 	}
@@ -6,11 +6,11 @@
 #include "Scene.h"
 #include "Entity.h"
 #include "Camera.h"
+#include "game_instance.hpp"
 #include "text.hpp"
 
 #include <vector>
 #include <stack>
-#include <random>
 
 #define SDL_MAIN_HANDLED
 
@@ -19,7 +19,6 @@
 #include <entities/screen.hpp>
 
 static const float MIN_DRAG_LENGTH = 10.f;
-static const float MAX_VELOCITY = 1250.f;
 
 static const char* const RETRO_COMPUTER_TTF = "data/fonts/RetroComputer/retro_computer_personal_use.ttf";
 
@@ -51,7 +50,11 @@ public:
 		return ActiveScene->GetCamera();
 	}
 
-	static bool is_ai_turn;
+	// The game being played, the menus and help are separate scenes outside of it
+	static GameInstance Game;
+
+	// Toggled with T, fast forwards enemy turns and bros settling after a sling
+	static bool turbo_mode;
 
 	static bool is_in_dialogue;
 
@@ -71,12 +74,9 @@ public:
 
 	// Collision callback function
 	void collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall);
-	void powerup_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, ECS_ENTT::Scene* gameScene);
-	void ground_spike_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
-	void tile_spike_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
-	void collidable_enemy_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
-	void projectile_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
-	void helge_projectile_collision_listener(ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j);
+
+	// Presents what the rules report for the shown game, with sounds and level changes
+	void game_event_listener(GameEvent event, ECS_ENTT::Entity entity_i, ECS_ENTT::Entity entity_j, bool hit_wall);
 
 	// Handle camera movement
 	void HandleCameraMovement(Camera* camera, float deltaTime);
@@ -84,6 +84,12 @@ public:
 	// Should the game be over ?
 	bool is_over() const;
 
+	// Whether to run several simulation steps per rendered frame
+	static bool is_fast_forwarding();
+
+	// Whether the player is aiming and nothing else is going on, such frames shouldn't allocate
+	static bool is_settled();
+
 	bool getIsLoadNextLevel();
 
 	void setIsLoadNextLevel(bool b);
@@ -154,10 +160,25 @@ private:
 
 	static unsigned int set_next_player();
 
+	// Restores the state at the start of the last turn
+	void rewind_turn();
+
 	unsigned int get_level_number();
 
 	void load_level(const std::string& string, size_t num_players_to_spawn);
 
+	// Deletes the game scene along with its camera, swarms and arena
+	void unload_game_scene();
+
+	// Sets up the HUD and camera of a freshly loaded game scene and switches to it
+	void enter_game_scene();
+
+	// Starts the background music of the game scene
+	void play_scene_music();
+
+	// Puts the game scene back the way its level was loaded, without reading the level file again
+	void restore_pristine_level();
+
 	void draw_projected_path(ECS_ENTT::Entity slingBro, vec2 mouse_pos);
 
 	void update_projected_path(float elapsed_ms);
@@ -175,6 +196,9 @@ private:
 	// Levels in the game
 	std::vector<std::string> levels;
 
+	// Title last handed to GLFW
+	char window_title[256] = "";
+
 	// music references
 	Mix_Chunk* salmon_dead_sound;
 	Mix_Chunk* salmon_eat_sound;
@@ -186,22 +210,14 @@ private:
 	Mix_Chunk* poppin_click_sound;
 	Mix_Chunk* disabled_click_sound;
 	Mix_Chunk* transport_sound;
-	Mix_Chunk* short_grass_sound;
-	Mix_Chunk* shorter_grass_sound;
 	Mix_Chunk* short_thud_sound;
 	Mix_Chunk* power_up_sound;
-	Mix_Chunk* sizzle_sound;
 	Mix_Chunk* power_up_8bit_sound;
 	Mix_Chunk* balloon_tap_sound;
 	Mix_Chunk* snail_monster_sound;
 	Mix_Chunk* squeak_sound;
 	Mix_Chunk* short_monster_sound;
-	Mix_Chunk* sand_skidding_sound;
-	Mix_Chunk* tapping_glass_sound;
-	Mix_Chunk* snow_steppin_sound;
-
 
-	// C++ random number generator
-	std::default_random_engine rng;
-	std::uniform_real_distribution<float> uniform_dist; // number between 0..1
+	// Sound of hitting each material, indexed by material id
+	std::vector<Mix_Chunk*> material_sounds;
 };
@@ -0,0 +1,76 @@
+#define GL3W_IMPLEMENTATION
+
+#include <gl3w.h>
+
+// stlib
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <string>
+
+// internal
+#include "common.hpp"
+#include "world.hpp"
+#include "render.hpp"
+#include "game_instance.hpp"
+#include "loader/level_manager.hpp"
+#include "entities/start_tile.hpp"
+
+// Loads a level into two games seeded alike, steps them side by side and checks that they end up in the same state
+static bool check_determinism(const std::string& level_file_path, int steps)
+{
+	const uint64_t seed = Random::MasterSeed();
+	GameBatch batch;
+	for (int i = 0; i < 2; i++)
+	{
+		std::unique_ptr<ECS_ENTT::Scene> scene(LevelManager::load_level(level_file_path, new Camera()));
+		if (!scene)
+			return false;
+
+		// A bro on the start tile for the enemies to go after
+		auto startTile = scene->m_Registry.view<StartTile>();
+		if (!startTile.empty())
+		{
+			vec3 position = scene->m_Registry.get<Motion>(startTile.front()).position + vec3(0.f, SPRITE_SCALE / 2.f, 0.f);
+			LevelManager::create_entity(S0, position, scene.get()).GetComponent<Turn>().order = 0;
+			scene->SetNumPlayer(1);
+		}
+
+		GameInstance& game = batch.add(std::move(scene));
+		game.random = RandomStream(seed);
+	}
+
+	batch.step(steps);
+
+	// Same seed and same level, so the games must agree to the bit
+	const GameBatchState& state = batch.state();
+	size_t count = state.offsets[1] - state.offsets[0];
+	bool same = count == state.offsets[2] - state.offsets[1] && state.isAITurn[0] == state.isAITurn[1] && state.results[0] == state.results[1];
+	for (size_t i = 0; same && i < count; i++)
+	{
+		size_t a = state.offsets[0] + i;
+		size_t b = state.offsets[1] + i;
+		same = state.entities[a] == state.entities[b] && state.positions[a] == state.positions[b] && state.velocities[a] == state.velocities[b];
+	}
+
+	printf("Batch check of '%s' after %d steps: %s (%lu entities per game)\n", level_file_path.c_str(), steps,
+		same ? "games agree" : "games DIVERGED", (unsigned long)count);
+	return same;
+}
+
+// Checks that batched games stay in lockstep, e.g. batchCheck 1P_Enemies 3600
+int main(int argc, char* argv[])
+{
+	if (argc < 2)
+	{
+		printf("Usage: %s <level> [steps]\n", argv[0]);
+		return EXIT_FAILURE;
+	}
+	int steps = argc > 2 ? atoi(argv[2]) : 60 * 60; // A minute of play by default
+
+	// Loading a level creates meshes, so it needs the window's GL context
+	WorldSystem world(WINDOW_SIZE_IN_PX);
+	RenderSystem renderer(*world.window);
+
+	return check_determinism(levels_path(yaml_file(argv[1])), steps) ? EXIT_SUCCESS : EXIT_FAILURE;
+}